@@ -132,6 +132,80 @@ def create_comprehensive_graph(data, filepath):
     print(f"✅ Graphique sauvegardé : {output_file}")
     plt.close(fig)
 
+def find_holds(data, min_duration=2.0):
+    """Repère les paliers : consigne constante (≥ min_duration minutes) atteinte après une montée."""
+    holds = []
+    target = data['target']
+    n = len(target)
+    i = 2
+    while i < n:
+        # Début de palier : consigne stable juste après une montée
+        flat = abs(target[i] - target[i-1]) <= 0.05
+        rising = target[i-1] > target[i-2] + 0.05
+        if not (flat and rising):
+            i += 1
+            continue
+        start = i - 1
+        end = i
+        while end + 1 < n and abs(target[end+1] - target[start]) <= 0.05:
+            end += 1
+        if data['time'][end] - data['time'][start] >= min_duration:
+            holds.append((start, end))
+        i = end + 1
+    return holds
+
+def ramp_corner_time(data, ramp_start, hold_start, smooth_max=100.0):
+    """
+    Instant où la rampe linéaire aurait atteint le palier (coin vif, sans arrondi Smooth).
+    La vitesse est mesurée sur la partie de la montée hors fenêtre d'arrondi (≤ palier - smooth_max),
+    à défaut sur le premier quart de la montée (pente initiale = vitesse programmée).
+    """
+    time = data['time'][ramp_start:hold_start+1]
+    target = data['target'][ramp_start:hold_start+1]
+    level = target[-1]
+    linear = target <= level - smooth_max
+    if np.sum(linear) < 2 or time[linear][-1] - time[linear][0] < 2.0:
+        linear = time <= time[0] + (time[-1] - time[0]) / 4
+    if np.sum(linear) < 2:
+        return data['time'][hold_start]
+    speed, offset = np.polyfit(time[linear], target[linear], 1)
+    if speed <= 0:
+        return data['time'][hold_start]
+    return min((level - offset) / speed, data['time'][hold_start])
+
+def print_hold_statistics(data, tolerance=5.0):
+    """Dépassement et temps de stabilisation à chaque palier (comparaison avec/sans arrondi Smooth)."""
+    holds = find_holds(data)
+    if not holds:
+        return
+    
+    print(f"\n🎯 Paliers (tolérance ±{tolerance:.0f}°C, mesurés depuis la fin de rampe linéaire théorique) :")
+    ramp_start = 0
+    for n, (start, end) in enumerate(holds, 1):
+        level = data['target'][start]
+        
+        # Référence commune avec/sans Smooth : l'arrondi retarde l'arrivée de la consigne au palier,
+        # compter depuis ce moment avantagerait les cuissons arrondies
+        corner = ramp_corner_time(data, ramp_start, start)
+        ramp_start = end + 1
+        first = int(np.searchsorted(data['time'], corner))
+        temp = data['temp'][first:end+1]
+        time = data['time'][first:end+1]
+        overshoot = max(0.0, np.max(temp) - level)
+        
+        # Stabilisé = dernier instant hors tolérance, la température y reste ensuite jusqu'à la fin du palier
+        outside = np.where(np.abs(temp - level) > tolerance)[0]
+        if len(outside) == 0:
+            settle = "0.0 min"
+        elif outside[-1] == len(temp) - 1:
+            settle = "non stabilisé"
+        else:
+            settle = f"{time[outside[-1] + 1] - corner:.1f} min"
+        delay = data['time'][start] - corner
+        print(f"   • Palier {n} à {level:.0f}°C ({data['time'][end] - data['time'][start]:.0f} min) : "
+              f"dépassement {overshoot:.1f}°C, stabilisation {settle} "
+              f"(consigne au palier +{delay:.1f} min)")
+
 def print_statistics(data):
     """Affiche des statistiques sur le cycle."""
     print("\n" + "="*60)
@@ -166,6 +240,8 @@ def print_statistics(data):
     print(f"   • Puissance maximale : {np.max(data['power']):.0f}%")
     print(f"   • Temps à 100% : {np.sum(data['power'] == 100) * 5 / 60:.1f} minutes")
     
+    print_hold_statistics(data)
+    
     # Détecter les anomalies de température (variations > 10°C)
     temp_diff = np.diff(data['temp'])
     anomalies = np.where(np.abs(temp_diff) > 10)[0]
@@ -5,25 +5,51 @@
 #ifndef DEFINITIONS_H
 #define DEFINITIONS_H
 
+#include <stdint.h>
+
 // ===== PROGRAM STATES =====
-enum ProgramState { PROG_OFF, PROG_ON, SETTINGS };
+enum ProgramState { PROG_OFF, PROG_ON, SETTINGS, HISTORY };
 enum Phase { PHASE_0, PHASE_1, PHASE_2, PHASE_3, PHASE_4_COOLDOWN };
 enum EditMode { NAV_MODE, EDIT_MODE };
 
 // ===== TIMING CONSTANTS =====
 #define TEMP_READ_INTERVAL 500
 #define DISPLAY_UPDATE_INTERVAL 100
-#define ENCODER_CHECK_INTERVAL 20
 #define TEMP_FAIL_TIMEOUT 120000
 #define EEPROM_WRITE_MIN_INTERVAL 10000
 
 // ===== FONCTIONNALITÉS OPTIONNELLES =====
 // Décommentez pour activer (voir ACTIVATION_FONCTIONNALITES.md pour détails)
+// LUCIA_BUILD_FEATURES est défini par memory_budget.py qui passe ses propres -DENABLE_*
+#ifndef LUCIA_BUILD_FEATURES
 #define ENABLE_LOGGING  // Logging Serial (~250 octets) - Monitoring/Debug
 //#define ENABLE_GRAPH    // Graphe température (~800 octets) - Visualisation
+//#define ENABLE_HISTORY  // Historique cuissons en EEPROM (+21 octets RAM) - Suivi usure résistances
+//#define ENABLE_FULL_BUFFER  // Écran en mode full buffer (+768 octets RAM) - Mega uniquement, RAM Uno insuffisante
+#endif
 
 // ===== GRAPH CONSTANTS =====
-#define GRAPH_SIZE 64  // Nombre de points (64 points = ~2-3h couverture)
+#define GRAPH_SIZE 84     // Nombre de buckets min/max/dernier (84 x 3 = 252 octets)
+#define GRAPH_MIN_SPAN 5  // Durée initiale d'un bucket (secondes), doublée à chaque fusion
+
+// ===== HISTORY CONSTANTS =====
+#define KILN_POWER_W 3000  // Puissance nominale des résistances (W) pour l'estimation d'énergie
+
+// ===== RUNTIME FLAGS =====
+// Booléens d'état regroupés en champs de bits : 1 octet au lieu de 5
+struct RuntimeFlags {
+  uint8_t tempFailActive : 1;      // Lecture sonde en échec (délai TEMP_FAIL_TIMEOUT en cours)
+  uint8_t criticalErrorActive : 1; // MAX31856 non détecté au démarrage
+  uint8_t plateauReached : 1;      // Température de palier atteinte (attente en cours)
+  uint8_t eepromWriteAllowed : 1;  // Première écriture EEPROM autorisée sans délai
+  uint8_t showGraph : 1;           // Écran graphe affiché (ENABLE_GRAPH)
+};
+
+// Temps écoulé sur 16 bits pour les intervalles courts (< 65 s) : 2 octets RAM par horodatage
+// Le type de retour tronque la soustraction, ce qui gère le débordement de millis()
+static inline uint16_t elapsed16(unsigned long now, uint16_t since) {
+  return (uint16_t)now - since;
+}
 
 // ===== FIRING PARAMETERS STRUCTURE =====
 struct FiringParams {
@@ -48,6 +74,7 @@ struct SettingsParams {
   float kd;        // Gain dérivé PID
   int maxDelta;    // Erreur max (°C) pour passer à phase suivante
   int maxTemp;     // Température max du four (°C)
+  int smoothing;   // Fenêtre d'arrondi montée -> palier (°C), 0 = désactivé
 };
 
 #endif
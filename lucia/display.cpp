@@ -5,12 +5,24 @@
 #include "definitions.h"
 #include "display.h"
 #include "temperature.h"
+#include "history.h"
 
 // Buffer partagé pour économiser la RAM (utilisé par toutes les fonctions d'affichage)
 static char sharedBuffer[20];
 
+// Les textes fixes restent en Flash : lus caractère par caractère depuis F()
+// (pas de passage par la classe Print, ni par sharedBuffer que l'appelant peut occuper)
+void drawStrF(int x, int y, const __FlashStringHelper* str) {
+  const char* p = (const char*)str;
+  char c;
+  while ((c = pgm_read_byte(p++)) != 0) {
+    x += u8g2.drawGlyph(x, y, c);
+  }
+}
+
+// label et unit sont en Flash (PSTR)
 void drawParamInline(int x, int y, const char* label, int value, const char* unit, int paramIndex) {
-  snprintf(sharedBuffer, 20, "%s%d%s", label, value, unit);
+  snprintf_P(sharedBuffer, 20, PSTR("%S%d%S"), label, value, unit);
   int w = strlen(sharedBuffer) * 6;
   
   if (selectedParam == paramIndex) {
@@ -37,54 +49,54 @@ void drawProgOffScreen() {
   u8g2.setFont(u8g2_font_6x10_tf);
   
   // Température actuelle en haut (ou WARN si défaillance sonde)
-  if (tempFailActive) {
-    u8g2.drawStr(0, 10, "WARN");
+  if (flags.tempFailActive) {
+    drawStrF(0, 10, F("WARN"));
   } else if (isnan(currentTemp)) {
-    u8g2.drawStr(0, 10, "?C");
+    drawStrF(0, 10, F("?C"));
   } else {
     int tempInt = (int)(currentTemp + 0.5);
-    snprintf(sharedBuffer, 20, "%dC", tempInt);
+    snprintf_P(sharedBuffer, 20, PSTR("%dC"), tempInt);
     u8g2.drawStr(0, 10, sharedBuffer);
   }
   
   // Phase 1 - Ligne 1
-  u8g2.drawStr(0, 22, "P1:");
-  drawParamInline(18, 22, "", params.step1Speed, "C/h", 1);
-  drawParamInline(60, 22, ">", params.step1Temp, "C", 2);
-  drawParamInline(105, 22, "", params.step1Wait, "m", 3);
+  drawStrF(0, 22, F("P1:"));
+  drawParamInline(18, 22, PSTR(""), params.step1Speed, PSTR("C/h"), 1);
+  drawParamInline(60, 22, PSTR(">"), params.step1Temp, PSTR("C"), 2);
+  drawParamInline(105, 22, PSTR(""), params.step1Wait, PSTR("m"), 3);
   
   // Phase 2 - Ligne 2
-  u8g2.drawStr(0, 34, "P2:");
-  drawParamInline(18, 34, "", params.step2Speed, "C/h", 4);
-  drawParamInline(60, 34, ">", params.step2Temp, "C", 5);
-  drawParamInline(105, 34, "", params.step2Wait, "m", 6);
+  drawStrF(0, 34, F("P2:"));
+  drawParamInline(18, 34, PSTR(""), params.step2Speed, PSTR("C/h"), 4);
+  drawParamInline(60, 34, PSTR(">"), params.step2Temp, PSTR("C"), 5);
+  drawParamInline(105, 34, PSTR(""), params.step2Wait, PSTR("m"), 6);
   
   // Phase 3 - Ligne 3
-  u8g2.drawStr(0, 46, "P3:");
-  drawParamInline(18, 46, "", params.step3Speed, "C/h", 7);
-  drawParamInline(60, 46, ">", params.step3Temp, "C", 8);
-  drawParamInline(105, 46, "", params.step3Wait, "m", 9);
+  drawStrF(0, 46, F("P3:"));
+  drawParamInline(18, 46, PSTR(""), params.step3Speed, PSTR("C/h"), 7);
+  drawParamInline(60, 46, PSTR(">"), params.step3Temp, PSTR("C"), 8);
+  drawParamInline(105, 46, PSTR(""), params.step3Wait, PSTR("m"), 9);
   
   // Cooldown - Ligne 4
-  u8g2.drawStr(0, 58, "Cool:");
-  drawParamInline(30, 58, "", params.step4Speed, "C/h", 10);
-  drawParamInline(80, 58, "<", params.step4Target, "C", 11);
+  drawStrF(0, 58, F("Cool:"));
+  drawParamInline(30, 58, PSTR(""), params.step4Speed, PSTR("C/h"), 10);
+  drawParamInline(80, 58, PSTR("<"), params.step4Target, PSTR("C"), 11);
   
   // Settings en haut à droite (maintenant index 0)
   if (selectedParam == 0 && editMode == NAV_MODE) {
     // Cadre de sélection autour de "Settings"
     u8g2.drawFrame(73, 0, 55, 12);
-    u8g2.drawStr(75, 10, "Settings");
+    drawStrF(75, 10, F("Settings"));
   } else if (selectedParam == 0 && editMode == EDIT_MODE) {
     // Inversion vidéo pour "Settings"
     u8g2.setDrawColor(1);
     u8g2.drawBox(73, 0, 55, 12);
     u8g2.setDrawColor(0);
-    u8g2.drawStr(75, 10, "Settings");
+    drawStrF(75, 10, F("Settings"));
     u8g2.setDrawColor(1);
   } else {
     // Affichage normal de "Settings"
-    u8g2.drawStr(75, 10, "Settings");
+    drawStrF(75, 10, F("Settings"));
   }
 }
 
@@ -100,43 +112,56 @@ void updateSettingsScrollOffset() {
 
 
 void drawSettingsItem(int itemIndex, int y) {
-  const char* label;
+  const __FlashStringHelper* label;
   
   switch (itemIndex) {
     case 0: 
-      label = "Heat Cycle"; 
-      snprintf(sharedBuffer, 20, "%dms", settings.pcycle); 
+      label = F("Heat Cycle"); 
+      snprintf_P(sharedBuffer, 20, PSTR("%dms"), settings.pcycle); 
       break;
     case 1: 
-      label = "Kp"; 
+      label = F("Kp"); 
       dtostrf(KP, 4, 1, sharedBuffer); 
       break;
     case 2: 
-      label = "Ki"; 
+      label = F("Ki"); 
       dtostrf(KI, 6, 3, sharedBuffer);  // 3 décimales pour incrément de 0.005
       break;
     case 3:  // Max delta
-      label = "Max delta"; 
-      snprintf(sharedBuffer, 20, "%dC", settings.maxDelta); 
+      label = F("Max delta"); 
+      snprintf_P(sharedBuffer, 20, PSTR("%dC"), settings.maxDelta); 
       break;
     case 4:  // Max Temp - température max du four
-      label = "Max Temp"; 
-      snprintf(sharedBuffer, 20, "%dC", settings.maxTemp); 
+      label = F("Max Temp"); 
+      snprintf_P(sharedBuffer, 20, PSTR("%dC"), settings.maxTemp); 
       break;
-    case 5:  // Exit
-      label = "Exit"; 
-      strcpy(sharedBuffer, "<--");
+    case 5:  // Smooth - arrondi montée -> palier (0 = coin vif)
+      label = F("Smooth");
+      if (settings.smoothing == 0) strcpy_P(sharedBuffer, PSTR("Off"));
+      else snprintf_P(sharedBuffer, 20, PSTR("%dC"), settings.smoothing);
+      break;
+    #ifdef ENABLE_HISTORY
+    case 6:  // Historique des cuissons
+      label = F("History");
+      snprintf_P(sharedBuffer, 20, PSTR("%d>"), getHistoryCount());
+      break;
+    case 7:  // Exit
+    #else
+    case 6:  // Exit
+    #endif
+      label = F("Exit"); 
+      strcpy_P(sharedBuffer, PSTR("<--"));
       break;
   }
   
-  u8g2.drawStr(2, y, label);
+  drawStrF(2, y, label);
   u8g2.drawStr(126 - strlen(sharedBuffer) * 6, y, sharedBuffer);
 }
 
 void drawSettingsScreen() {
   u8g2.setFont(u8g2_font_6x10_tf);
-  u8g2.drawStr(0, 10, "SETTINGS");
-  u8g2.drawStr(98, 10, "v01.0");  // Version alignée à droite
+  drawStrF(0, 10, F("SETTINGS"));
+  drawStrF(98, 10, F("v01.0"));  // Version alignée à droite
   updateSettingsScrollOffset();
   
   for (int i = 0; i < 4; i++) {
@@ -161,16 +186,90 @@ void drawSettingsScreen() {
   }
 }
 
+#ifdef ENABLE_HISTORY
+// Ligne "label ........ valeur" (valeur dans sharedBuffer, alignée à droite)
+static void drawHistoryLine(int y, const __FlashStringHelper* label) {
+  drawStrF(0, y, label);
+  u8g2.drawStr(128 - strlen(sharedBuffer) * 6, y, sharedBuffer);
+}
+
+void drawHistoryScreen() {
+  // Écran historique : une cuisson par page, l'encodeur parcourt les cuissons
+  u8g2.setFont(u8g2_font_6x10_tf);
+  
+  uint8_t count = getHistoryCount();
+  FiringRecord rec;
+  if (count == 0 || !getHistoryRecord(selectedHistory, rec)) {
+    drawStrF(0, 10, F("HISTORY"));
+    drawStrF(0, 35, F("No firing yet"));
+    return;
+  }
+  
+  // Titre : position dans l'historique + numéro de cuisson
+  snprintf_P(sharedBuffer, 20, PSTR("HISTORY %d/%d"), selectedHistory + 1, count);
+  u8g2.drawStr(0, 10, sharedBuffer);
+  snprintf_P(sharedBuffer, 20, PSTR("#%u"), rec.seq);
+  u8g2.drawStr(128 - strlen(sharedBuffer) * 6, 10, sharedBuffer);
+  
+  // Résumé : palier final, durée, fin de cuisson
+  snprintf_P(sharedBuffer, 20, PSTR("%uC %uh%02u "), rec.peakTarget,
+             rec.durationMin / 60, rec.durationMin % 60);
+  u8g2.drawStr(0, 20, sharedBuffer);
+  int endX = strlen(sharedBuffer) * 6;
+  if (rec.endReason == HIST_END_DONE) drawStrF(endX, 20, F("OK"));
+  else if (rec.endReason == HIST_END_STOPPED) drawStrF(endX, 20, F("STOP"));
+  else drawStrF(endX, 20, F("FAIL"));
+  
+  u8g2.drawHLine(0, 22, 128);
+  
+  snprintf_P(sharedBuffer, 20, PSTR("%uC"), rec.maxTemp);
+  drawHistoryLine(31, F("Max Temp"));
+  
+  snprintf_P(sharedBuffer, 20, PSTR("+%u/-%uC"), rec.overshoot, rec.rampLag);
+  drawHistoryLine(42, F("Over/Lag"));
+  
+  // Indicateur d'usure : temps à 100% pour tenir la rampe
+  snprintf_P(sharedBuffer, 20, PSTR("%um"), rec.fullPowerMin);
+  drawHistoryLine(53, F("Full Power"));
+  
+  // Énergie en kWh (1 décimale) : minutes pleine puissance x KILN_POWER_W
+  unsigned long dWh = (unsigned long)rec.energyMin * KILN_POWER_W / 6000UL;
+  snprintf_P(sharedBuffer, 20, PSTR("%lu.%lukWh"), dWh / 10, dWh % 10);
+  drawHistoryLine(63, F("Energy"));
+}
+#endif
+
+#if ZONE_COUNT > 1
+// Valeurs des zones séparées par '/' dans sharedBuffer (ex : "1050/1042C" ou "45/60%")
+static void formatZoneValues(bool power) {
+  uint8_t len = 0;
+  for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+    if (z > 0) sharedBuffer[len++] = '/';
+    if (power) {
+      len += snprintf_P(sharedBuffer + len, 20 - len, PSTR("%d"), getZonePowerHold(z));
+    } else {
+      float t = getZoneTemperature(z);
+      if (isnan(t)) {
+        sharedBuffer[len++] = '?';
+        sharedBuffer[len] = 0;
+      } else {
+        len += snprintf_P(sharedBuffer + len, 20 - len, PSTR("%d"), (int)(t + 0.5));
+      }
+    }
+  }
+  strcpy_P(sharedBuffer + len, power ? PSTR("%") : PSTR("C"));
+}
+#endif
+
 void drawProgOnScreen(unsigned long currentMillis) {
   // Écran de cuisson en cours : affiche les informations de la phase active
   // Une seule fonte pour uniformité : u8g2_font_6x10_tf
   float currentTemp = getCurrentTemperature();
-  int powerHold = getPowerHold();
   
   u8g2.setFont(u8g2_font_6x10_tf);
   
   // Déterminer les informations de la phase en cours
-  const char* phaseTitle = "";
+  const __FlashStringHelper* phaseTitle = F("");
   int phaseTargetTemp = 0;
   int phaseSpeed = 0;
   int phaseWait = 0;
@@ -178,7 +277,7 @@ void drawProgOnScreen(unsigned long currentMillis) {
   
   switch (currentPhase) {
     case PHASE_1:
-      phaseTitle = "Phase 1";
+      phaseTitle = F("Phase 1");
       phaseTargetTemp = params.step1Temp;
       phaseSpeed = params.step1Speed;
       phaseWait = params.step1Wait;
@@ -186,63 +285,77 @@ void drawProgOnScreen(unsigned long currentMillis) {
       phaseStartTemp = 0.0;
       break;
     case PHASE_2:
-      phaseTitle = "Phase 2";
+      phaseTitle = F("Phase 2");
       phaseTargetTemp = params.step2Temp;
       phaseSpeed = params.step2Speed;
       phaseWait = params.step2Wait;
       phaseStartTemp = params.step1Temp;
       break;
     case PHASE_3:
-      phaseTitle = "Phase 3";
+      phaseTitle = F("Phase 3");
       phaseTargetTemp = params.step3Temp;
       phaseSpeed = params.step3Speed;
       phaseWait = params.step3Wait;
       phaseStartTemp = params.step2Temp;
       break;
     case PHASE_4_COOLDOWN:
-      phaseTitle = "Cool Down";
+      phaseTitle = F("Cool Down");
       phaseTargetTemp = params.step4Target;
       phaseSpeed = params.step4Speed;
       phaseWait = 0;
       phaseStartTemp = params.step3Temp;
       break;
     default:
-      phaseTitle = "Unknown";
+      phaseTitle = F("Unknown");
       break;
   }
   
   // Affichage du titre
-  u8g2.drawStr(0, 10, phaseTitle);
+  drawStrF(0, 10, phaseTitle);
   
   // Warning si actif
-  if (tempFailActive) {
-    u8g2.drawStr(90, 10, "WARN");
+  if (flags.tempFailActive) {
+    drawStrF(90, 10, F("WARN"));
   }
   
   // Ligne suivante : résumé des valeurs de la phase (fonte uniforme)
   if (currentPhase == PHASE_4_COOLDOWN) {
-    snprintf(sharedBuffer, 20, "%dC/h->%dC", phaseSpeed, phaseTargetTemp);
+    snprintf_P(sharedBuffer, 20, PSTR("%dC/h->%dC"), phaseSpeed, phaseTargetTemp);
   } else {
-    snprintf(sharedBuffer, 20, "%dC/h->%dC,%dm", phaseSpeed, phaseTargetTemp, phaseWait);
+    snprintf_P(sharedBuffer, 20, PSTR("%dC/h->%dC,%dm"), phaseSpeed, phaseTargetTemp, phaseWait);
   }
   u8g2.drawStr(0, 20, sharedBuffer);
   
   // Ligne de séparation horizontale
   u8g2.drawHLine(0, 22, 128);
   
-  // Temp Read (température de la sonde)
-  u8g2.drawStr(0, 31, "Temp Read");
-  snprintf(sharedBuffer, 20, isnan(currentTemp) ? "?C" : "%dC", (int)(currentTemp + 0.5));
+  // Temp Read (température de la sonde, une valeur par zone)
+  #if ZONE_COUNT > 1
+  drawStrF(0, 31, F("Read"));
+  formatZoneValues(false);
+  #else
+  drawStrF(0, 31, F("Temp Read"));
+  if (isnan(currentTemp)) {
+    strcpy_P(sharedBuffer, PSTR("?C"));
+  } else {
+    snprintf_P(sharedBuffer, 20, PSTR("%dC"), (int)(currentTemp + 0.5));
+  }
+  #endif
   u8g2.drawStr(128 - strlen(sharedBuffer) * 6, 31, sharedBuffer);
   
   // Temp Target (température cible calculée)
-  u8g2.drawStr(0, 42, "Temp Target");
-  snprintf(sharedBuffer, 20, "%dC", (int)(targetTemp + 0.5));
+  drawStrF(0, 42, F("Temp Target"));
+  snprintf_P(sharedBuffer, 20, PSTR("%dC"), (int)(targetTemp + 0.5));
   u8g2.drawStr(128 - strlen(sharedBuffer) * 6, 42, sharedBuffer);
   
-  // Heat Power (PowerHold)
-  u8g2.drawStr(0, 53, "Heat Power");
-  snprintf(sharedBuffer, 20, "%d%%", powerHold);
+  // Heat Power (PowerHold, une valeur par zone)
+  #if ZONE_COUNT > 1
+  drawStrF(0, 53, F("Power"));
+  formatZoneValues(true);
+  #else
+  drawStrF(0, 53, F("Heat Power"));
+  snprintf_P(sharedBuffer, 20, PSTR("%d%%"), getPowerHold());
+  #endif
   u8g2.drawStr(128 - strlen(sharedBuffer) * 6, 53, sharedBuffer);
   
   // Phase : pourcentage
@@ -256,53 +369,44 @@ void drawProgOnScreen(unsigned long currentMillis) {
       pp = (int)((prog / range) * 100);
       if (pp < 0) pp = 0;
       if (pp > 100) pp = 100;
-    } else if (plateauReached || currentTemp >= phaseTargetTemp) {
+    } else if (flags.plateauReached || currentTemp >= phaseTargetTemp) {
       pp = 100;
     }
   }
-  u8g2.drawStr(0, 63, "Phase");
-  snprintf(sharedBuffer, 20, "%d%%", pp);
+  drawStrF(0, 63, F("Phase"));
+  snprintf_P(sharedBuffer, 20, PSTR("%d%%"), pp);
   u8g2.drawStr(128 - strlen(sharedBuffer) * 6, 63, sharedBuffer);
 }
 
 #ifdef ENABLE_GRAPH
-float uint8ToTempDisplay(uint8_t value) {
-  return (float)value * 1280.0 / 255.0;
+// Zone de graphe : agrandie pour utiliser tout l'écran
+static const int GRAPH_X = 2;
+static const int GRAPH_Y = 2;
+static const int GRAPH_WIDTH = 124;
+static const int GRAPH_HEIGHT = 60;
+
+// Conversion température -> ordonnée écran (bornée à la zone de graphe)
+static int graphY(float temp, float tempMax) {
+  int y = GRAPH_Y + GRAPH_HEIGHT - 1 - (int)(temp * (GRAPH_HEIGHT - 1) / tempMax);
+  if (y < GRAPH_Y) y = GRAPH_Y;
+  if (y > GRAPH_Y + GRAPH_HEIGHT - 1) y = GRAPH_Y + GRAPH_HEIGHT - 1;
+  return y;
+}
+
+// Conversion valeur stockée (uint8, pas de ~5°C) -> ordonnée écran
+static int graphYStored(uint8_t value, float tempMax) {
+  return graphY((float)value * 1280.0 / 255.0, tempMax);
 }
 
-float calculateTheoreticalTarget(uint16_t t) {
-  const float T0 = 20.0;
-  // Calcul durées (secondes)
-  uint16_t r1 = params.step1Speed ? (params.step1Temp - T0) * 3600UL / params.step1Speed : 0;
-  uint16_t p1 = params.step1Wait * 60;
-  uint16_t e1 = r1 + p1;
-  
-  uint16_t r2 = params.step2Speed ? (params.step2Temp - params.step1Temp) * 3600UL / params.step2Speed : 0;
-  uint16_t p2 = params.step2Wait * 60;
-  uint16_t e2 = e1 + r2 + p2;
-  
-  uint16_t r3 = params.step3Speed ? (params.step3Temp - params.step2Temp) * 3600UL / params.step3Speed : 0;
-  uint16_t p3 = params.step3Wait * 60;
-  
-  // Déterminer température
-  if (t <= r1) return r1 ? T0 + (params.step1Temp - T0) * t / r1 : params.step1Temp;
-  if (t <= e1) return params.step1Temp;
-  if (t <= e1 + r2) return r2 ? params.step1Temp + (params.step2Temp - params.step1Temp) * (t - e1) / r2 : params.step2Temp;
-  if (t <= e2) return params.step2Temp;
-  if (t <= e2 + r3) return r3 ? params.step2Temp + (params.step3Temp - params.step2Temp) * (t - e2) / r3 : params.step3Temp;
-  return params.step3Temp;
+static int graphX(unsigned long t, unsigned long maxTime) {
+  int x = GRAPH_X + (int)(t * GRAPH_WIDTH / maxTime);
+  return (x > GRAPH_X + GRAPH_WIDTH - 1) ? GRAPH_X + GRAPH_WIDTH - 1 : x;
 }
 
 void drawGraph() {
-  // Écran de graphe : affiche la courbe de consigne et les points mesurés
+  // Écran de graphe : affiche la courbe de consigne et l'enveloppe des mesures
   u8g2.setFont(u8g2_font_6x10_tf);
   
-  // Définir la zone de graphe : agrandie pour utiliser tout l'écran
-  const int GRAPH_X = 2;
-  const int GRAPH_Y = 2;
-  const int GRAPH_WIDTH = 124;
-  const int GRAPH_HEIGHT = 60;
-  
   // Dessiner le cadre du graphe
   u8g2.drawFrame(GRAPH_X - 1, GRAPH_Y - 1, GRAPH_WIDTH + 2, GRAPH_HEIGHT + 2);
   
@@ -331,86 +435,83 @@ void drawGraph() {
   
   // Terme P sur la première ligne (Y = 10)
   dtostrf(cachedP, 4, 1, floatBuf); // 4 caractères total, 1 décimale (ex: "12.5" ou "-3.2")
-  snprintf(pidBuf, 12, "P:%s", floatBuf);
+  snprintf_P(pidBuf, 12, PSTR("P:%s"), floatBuf);
   u8g2.drawStr(PID_X, 10, pidBuf);
   
   // Terme I sur la deuxième ligne (Y = 20)
   dtostrf(cachedI, 4, 1, floatBuf);
-  snprintf(pidBuf, 12, "I:%s", floatBuf);
+  snprintf_P(pidBuf, 12, PSTR("I:%s"), floatBuf);
   u8g2.drawStr(PID_X, 20, pidBuf);
   
   // Terme D supprimé : non utilisé pour four céramique
   
-  // Calcul durée totale optimisé
-  uint32_t d = 0;
-  if (params.step1Speed) d += ((uint32_t)(params.step1Temp - 20) * 3600UL) / params.step1Speed;
-  d += (uint32_t)params.step1Wait * 60;
-  if (params.step2Speed) d += ((uint32_t)(params.step2Temp - params.step1Temp) * 3600UL) / params.step2Speed;
-  d += (uint32_t)params.step2Wait * 60;
-  if (params.step3Speed) d += ((uint32_t)(params.step3Temp - params.step2Temp) * 3600UL) / params.step3Speed;
-  d += (uint32_t)params.step3Wait * 60;
-  uint16_t totalDuration = (d < 60) ? 60 : d;
+  // Profil théorique : départ à 20°C puis (début d'arrondi, fin de rampe, fin de palier) pour chaque phase
+  // Avec Smooth, la consigne quitte la rampe à (palier - fenêtre) et met 2x plus de temps
+  // pour parcourir la fenêtre : même tracé que calculateTargetTemp()
+  const int stepTemp[3] = {params.step1Temp, params.step2Temp, params.step3Temp};
+  const int stepSpeed[3] = {params.step1Speed, params.step2Speed, params.step3Speed};
+  const int stepWait[3] = {params.step1Wait, params.step2Wait, params.step3Wait};
+  unsigned long profileTime[10];
+  int profileTemp[10];
+  profileTime[0] = 0;
+  profileTemp[0] = 20;
+  for (uint8_t k = 0; k < 3; k++) {
+    uint8_t p = 3 * k;
+    int prevTemp = profileTemp[p];
+    int window = 0;
+    unsigned long ramp = 0, blend = 0;
+    if (stepSpeed[k] && stepTemp[k] > prevTemp) {
+      window = min(settings.smoothing, stepTemp[k] - prevTemp);
+      ramp = (unsigned long)(stepTemp[k] - window - prevTemp) * 3600UL / stepSpeed[k];
+      blend = (unsigned long)window * 2 * 3600UL / stepSpeed[k];
+    }
+    profileTime[p + 1] = profileTime[p] + ramp;
+    profileTime[p + 2] = profileTime[p + 1] + blend;
+    profileTime[p + 3] = profileTime[p + 2] + (unsigned long)stepWait[k] * 60;
+    profileTemp[p + 1] = stepTemp[k] - window;
+    profileTemp[p + 2] = profileTemp[p + 3] = stepTemp[k];
+  }
   
-  // Limites du graphe : toujours de 0 à la durée totale du programme
-  uint16_t minTime = 0;
-  uint16_t maxTime = (uint16_t)totalDuration;
+  // Axe des temps : durée du programme, étendue si la cuisson dure plus longtemps
+  unsigned long maxTime = profileTime[9];
+  unsigned long recordedTime = (unsigned long)graphCount * graphBucketSpan;
+  if (recordedTime > maxTime) maxTime = recordedTime;
+  if (maxTime < 60) maxTime = 60;
   
   // Échelle température : 0°C à step3Temp (température max du programme)
-  float tempMin = 0;
   float tempMax = params.step3Temp;
   if (tempMax < 100) tempMax = 100; // Minimum 100°C pour l'échelle
   
-  // Courbe théorique (échantillonnage tous les 2 pixels pour réduire les calculs)
+  // Courbe théorique : 9 segments (arrondi approché par une corde)
+  for (uint8_t k = 0; k < 9; k++) {
+    u8g2.drawLine(graphX(profileTime[k], maxTime), graphY(profileTemp[k], tempMax),
+                  graphX(profileTime[k + 1], maxTime), graphY(profileTemp[k + 1], tempMax));
+  }
+  
+  // Mesures : une passe linéaire sur les buckets, barre min/max (pics) + courbe des dernières valeurs
   int lastX = -1, lastY = -1;
-  for (int px = 0; px < GRAPH_WIDTH; px += 2) {
-    uint16_t t = minTime + (uint32_t)(maxTime - minTime) * px / GRAPH_WIDTH;
-    float temp = calculateTheoreticalTarget(t);
-    int y = GRAPH_Y + GRAPH_HEIGHT - 1 - (int)((temp - tempMin) * (GRAPH_HEIGHT - 1) / (tempMax - tempMin));
-    if (y < GRAPH_Y) y = GRAPH_Y;
-    if (y > GRAPH_Y + GRAPH_HEIGHT - 1) y = GRAPH_Y + GRAPH_HEIGHT - 1;
-    int x = GRAPH_X + px;
+  for (uint8_t i = 0; i < graphCount; i++) {
+    int x = graphX((unsigned long)i * graphBucketSpan + graphBucketSpan / 2, maxTime);
+    int yTop = graphYStored(graphMax[i], tempMax);
+    int yBottom = graphYStored(graphMin[i], tempMax);
+    u8g2.drawVLine(x, yTop, yBottom - yTop + 1);
+    
+    int y = graphYStored(graphLast[i], tempMax);
     if (lastX >= 0) u8g2.drawLine(lastX, lastY, x, y);
     lastX = x; lastY = y;
   }
   
-  // Dessiner les points de mesure réels (petits carrés) seulement s'il y en a
-  if (graphCount > 0) {
-    for (uint8_t i = 0; i < graphCount; i++) {
-      uint8_t idx = i;
-      if (graphCount == GRAPH_SIZE) {
-        // Buffer plein : commencer à partir de graphIndex (le plus ancien)
-        idx = (graphIndex + i) % GRAPH_SIZE;
-      }
-      
-      uint16_t pointTime = graphTimeStamps[idx];
-      float pointTemp = uint8ToTempDisplay(graphTempRead[idx]);
-      
-      // Mapper sur les axes (sur toute la durée du programme)
-      int x = GRAPH_X + (int)((float)pointTime * GRAPH_WIDTH / maxTime);
-      int y = GRAPH_Y + GRAPH_HEIGHT - 1 - (int)((pointTemp - tempMin) * (GRAPH_HEIGHT - 1) / (tempMax - tempMin));
-      
-      // Limiter aux bornes
-      if (x < GRAPH_X) x = GRAPH_X;
-      if (x > GRAPH_X + GRAPH_WIDTH - 1) x = GRAPH_X + GRAPH_WIDTH - 1;
-      if (y < GRAPH_Y) y = GRAPH_Y;
-      if (y > GRAPH_Y + GRAPH_HEIGHT - 1) y = GRAPH_Y + GRAPH_HEIGHT - 1;
-      
-      
-      u8g2.drawBox(x - 1, y - 1, 2, 2);  // Carré de 2×2 pixels
-    }
-  }
-  
   // Afficher la durée totale en bas à gauche (en heures si > 60min, sinon en minutes)
   if (maxTime >= 3600) {
-    snprintf(sharedBuffer, 20, "%dh%02d", maxTime / 3600, (maxTime % 3600) / 60);
+    snprintf_P(sharedBuffer, 20, PSTR("%luh%02lu"), maxTime / 3600, (maxTime % 3600) / 60);
   } else {
-    snprintf(sharedBuffer, 20, "%dm", maxTime / 60);
+    snprintf_P(sharedBuffer, 20, PSTR("%lum"), maxTime / 60);
   }
   int maxTimeStrWidth = strlen(sharedBuffer) * 6;
   u8g2.drawStr(GRAPH_X + GRAPH_WIDTH - maxTimeStrWidth, 64, sharedBuffer);
   
   // Afficher la température max en haut à droite (aligné dynamiquement)
-  snprintf(sharedBuffer, 20, "%dC", (int)tempMax);
+  snprintf_P(sharedBuffer, 20, PSTR("%dC"), (int)tempMax);
   int tempMaxStrWidth = strlen(sharedBuffer) * 6;
   u8g2.drawStr(128 - tempMaxStrWidth, GRAPH_Y + 8, sharedBuffer);
 }
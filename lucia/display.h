@@ -8,8 +8,19 @@
 #include <U8g2lib.h>
 #include "definitions.h"
 
+// Mode d'affichage : full buffer (1 passe, 1024 octets) ou 2 pages (4 passes, 256 octets)
+#ifdef ENABLE_FULL_BUFFER
+#if defined(__AVR_ATmega328P__)
+// Estimation RAM Uno (voir ACTIVATION_FONCTIONNALITES.md) : ~2220 à ~2510 octets sur 2048
+#error "ENABLE_FULL_BUFFER : RAM insuffisante sur Arduino Uno (buffer 1024 octets), utiliser un Mega"
+#endif
+typedef U8G2_SH1106_128X64_NONAME_F_HW_I2C DisplayDriver;
+#else
+typedef U8G2_SH1106_128X64_NONAME_2_HW_I2C DisplayDriver;
+#endif
+
 // External references
-extern U8G2_SH1106_128X64_NONAME_2_HW_I2C u8g2;
+extern DisplayDriver u8g2;
 extern int selectedParam;
 extern int selectedSetting;
 extern EditMode editMode;
@@ -18,27 +29,33 @@ extern SettingsParams settings;
 extern ProgramState progState;
 extern Phase currentPhase;
 extern float targetTemp;
-extern bool tempFailActive;
+extern RuntimeFlags flags;
 extern unsigned long tempFailStartTime;
 extern unsigned long programStartTime;
 extern unsigned long phaseStartTime;
 extern unsigned long plateauStartTime;
-extern bool plateauReached;
 #ifdef ENABLE_GRAPH
-extern uint8_t graphTempRead[];
-extern uint8_t graphTempTarget[];
-extern uint16_t graphTimeStamps[];
-extern uint8_t graphIndex;
+extern uint8_t graphMin[];
+extern uint8_t graphMax[];
+extern uint8_t graphLast[];
 extern uint8_t graphCount;
+extern uint16_t graphBucketSpan;
 #endif
 extern int settingsScrollOffset;
 extern const int NUM_SETTINGS;
+#ifdef ENABLE_HISTORY
+extern int selectedHistory;
+#endif
 
 // Function declarations
+void drawStrF(int x, int y, const __FlashStringHelper* str); // Texte lu en Flash (F("..."))
 void drawProgOffScreen();
 void drawProgOnScreen(unsigned long currentMillis); // currentMillis pour éviter millis() dans la fonction
 void drawSettingsScreen();
 void drawGraph();
+#ifdef ENABLE_HISTORY
+void drawHistoryScreen();
+#endif
 void updateDisplay(unsigned long currentMillis); // currentMillis pour éviter les appels millis() supplémentaires
 // Note: readTemperature() et getPowerHold() sont déclarées dans temperature.h
 
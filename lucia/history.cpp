@@ -0,0 +1,192 @@
+/*
+ * history.cpp - Historique compact des cuissons (anneau en EEPROM)
+ *
+ * Chaque cuisson terminée est résumée en un FiringRecord de 16 octets.
+ * L'emplacement est déduit du numéro de cuisson (seq % HISTORY_SIZE) :
+ * pas d'index de tête à réécrire, une seule écriture EEPROM par cuisson.
+ */
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include "definitions.h"
+#include "history.h"
+
+#ifdef ENABLE_HISTORY
+
+// ===== EEPROM ADDRESSES =====
+// Après magic (0), params (2) et settings : zone libre à partir de 64
+#define HISTORY_MAGIC 0x4849  // "HI"
+#define EEPROM_ADDR_HISTORY_MAGIC 64
+#define EEPROM_ADDR_HISTORY 66
+
+// External references
+extern FiringParams params;
+extern unsigned long programStartTime;
+
+// Numérotation des cuissons
+static uint16_t nextSeq = 1;
+static uint8_t historyCount = 0;
+
+// Accumulateurs de la cuisson en cours (~16 octets RAM)
+static unsigned long lastHistorySample = 0;
+static unsigned long fullPowerSeconds = 0;
+static unsigned long energyPercentSeconds = 0; // Somme de puissance(%) x secondes
+static int maxTempReached = 0;
+static uint8_t maxOvershoot = 0;
+static uint8_t maxRampLag = 0;
+
+static int recordAddress(uint16_t seq) {
+  return EEPROM_ADDR_HISTORY + (seq % HISTORY_SIZE) * sizeof(FiringRecord);
+}
+
+// Empreinte CRC8 (polynôme 0x07) du programme pour reconnaître les cuissons identiques
+static uint8_t paramsFingerprint() {
+  const uint8_t* data = (const uint8_t*)&params;
+  uint8_t crc = 0;
+  for (uint8_t i = 0; i < sizeof(FiringParams); i++) {
+    crc ^= data[i];
+    for (uint8_t b = 0; b < 8; b++) {
+      crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : (crc << 1);
+    }
+  }
+  return crc;
+}
+
+static uint8_t saturateUint8(float value) {
+  if (value <= 0) return 0;
+  if (value >= 255) return 255;
+  return (uint8_t)(value + 0.5);
+}
+
+void initHistory() {
+  uint16_t magic;
+  EEPROM.get(EEPROM_ADDR_HISTORY_MAGIC, magic);
+
+  // Premier usage : marquer tous les emplacements comme vides
+  if (magic != HISTORY_MAGIC) {
+    uint16_t empty = 0;
+    for (uint8_t i = 0; i < HISTORY_SIZE; i++) {
+      EEPROM.put(recordAddress(i), empty);
+    }
+    EEPROM.put(EEPROM_ADDR_HISTORY_MAGIC, (uint16_t)HISTORY_MAGIC);
+  }
+
+  // Retrouver la cuisson la plus récente (seq le plus grand)
+  uint16_t maxSeq = 0;
+  historyCount = 0;
+  for (uint8_t i = 0; i < HISTORY_SIZE; i++) {
+    uint16_t seq;
+    EEPROM.get(recordAddress(i), seq);
+    if (seq != 0) {
+      historyCount++;
+      if (seq > maxSeq) maxSeq = seq;
+    }
+  }
+  nextSeq = maxSeq + 1;
+}
+
+void historyStartFiring() {
+  lastHistorySample = programStartTime;
+  fullPowerSeconds = 0;
+  energyPercentSeconds = 0;
+  maxTempReached = 0;
+  maxOvershoot = 0;
+  maxRampLag = 0;
+}
+
+void historyUpdate(float currentTemp, float targetTemp, int maxPower, int averagePower, bool heating, unsigned long currentMillis) {
+  // Échantillonnage à 1 Hz, suffisant vu l'inertie du four
+  unsigned long elapsed = currentMillis - lastHistorySample;
+  if (elapsed < 1000) return;
+  unsigned long seconds = elapsed / 1000;
+  lastHistorySample += seconds * 1000; // Conserver le reste pour ne pas dériver
+
+  // Puissance : indépendante de la sonde
+  // Temps à 100% sur la zone la plus sollicitée (usure), énergie sur la moyenne des zones
+  if (maxPower >= 100) fullPowerSeconds += seconds;
+  energyPercentSeconds += (unsigned long)averagePower * seconds;
+
+  if (isnan(currentTemp)) return;
+
+  if (currentTemp > maxTempReached) maxTempReached = (int)(currentTemp + 0.5);
+
+  // Dépassement et retard mesurés seulement en chauffe (le refroidissement est passif)
+  if (heating) {
+    uint8_t overshoot = saturateUint8(currentTemp - targetTemp);
+    uint8_t lag = saturateUint8(targetTemp - currentTemp);
+    if (overshoot > maxOvershoot) maxOvershoot = overshoot;
+    if (lag > maxRampLag) maxRampLag = lag;
+  }
+}
+
+void historyEndFiring(uint8_t endReason, unsigned long currentMillis) {
+  unsigned long duration = currentMillis - programStartTime;
+  if (duration < HISTORY_MIN_DURATION) return;
+
+  FiringRecord rec;
+  rec.seq = nextSeq;
+  rec.progId = paramsFingerprint();
+  rec.endReason = endReason;
+  rec.peakTarget = params.step3Temp;
+  rec.durationMin = duration / 60000UL;
+  rec.maxTemp = maxTempReached;
+  rec.overshoot = maxOvershoot;
+  rec.rampLag = maxRampLag;
+  rec.fullPowerMin = fullPowerSeconds / 60;
+  rec.energyMin = energyPercentSeconds / 6000UL; // %·s -> minutes à 100%
+
+  EEPROM.put(recordAddress(rec.seq), rec);
+
+  nextSeq++;
+  if (nextSeq == 0) nextSeq = 1; // 0 réservé aux emplacements vides
+  if (historyCount < HISTORY_SIZE) historyCount++;
+}
+
+uint8_t getHistoryCount() {
+  return historyCount;
+}
+
+bool getHistoryRecord(uint8_t index, FiringRecord &rec) {
+  if (index >= historyCount) return false;
+  uint16_t seq = nextSeq - 1 - index;
+  EEPROM.get(recordAddress(seq), rec);
+  return rec.seq == seq;
+}
+
+#ifdef ENABLE_LOGGING
+// Export CSV de l'historique (de la plus ancienne à la plus récente)
+void sendHistoryDump() {
+  Serial.println();
+  Serial.println(F("=== HISTORIQUE CUISSONS ==="));
+  // Lignes préfixées "H" : jamais prises pour des mesures par les scripts du Logger
+  // (qui acceptent toute ligne commençant par un chiffre)
+  Serial.println(F("H, Seq, ProgId, Fin, Palier(C), Duree(min), Max(C), Depassement(C), Retard(C), 100%(min), Energie(kWh)"));
+  FiringRecord rec;
+  for (int8_t i = historyCount - 1; i >= 0; i--) {
+    if (!getHistoryRecord(i, rec)) continue;
+    Serial.print(F("H, "));
+    Serial.print(rec.seq);
+    Serial.print(F(", "));
+    Serial.print(rec.progId, HEX);
+    Serial.print(F(", "));
+    Serial.print(rec.endReason);
+    Serial.print(F(", "));
+    Serial.print(rec.peakTarget);
+    Serial.print(F(", "));
+    Serial.print(rec.durationMin);
+    Serial.print(F(", "));
+    Serial.print(rec.maxTemp);
+    Serial.print(F(", "));
+    Serial.print(rec.overshoot);
+    Serial.print(F(", "));
+    Serial.print(rec.rampLag);
+    Serial.print(F(", "));
+    Serial.print(rec.fullPowerMin);
+    Serial.print(F(", "));
+    Serial.println(rec.energyMin * (KILN_POWER_W / 60000.0), 1);
+  }
+  Serial.println(F("---"));
+}
+#endif
+
+#endif
@@ -0,0 +1,51 @@
+/*
+ * history.h - Historique compact des cuissons (anneau en EEPROM)
+ */
+
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <Arduino.h>
+#include "definitions.h"
+
+#ifdef ENABLE_HISTORY
+
+// Nombre d'enregistrements conservés (anneau : la plus ancienne cuisson est écrasée)
+#define HISTORY_SIZE 16
+
+// Cuissons trop courtes (démarrage par erreur) non enregistrées pour épargner l'EEPROM
+#define HISTORY_MIN_DURATION 60000UL
+
+// Fin de cuisson (champ endReason)
+#define HIST_END_DONE 0      // Refroidissement terminé normalement
+#define HIST_END_STOPPED 1   // Arrêt manuel (bouton push)
+#define HIST_END_SENSOR 2    // Arrêt de sécurité : sonde en défaut > 2 min
+
+// Résumé d'une cuisson : 16 octets en EEPROM
+struct FiringRecord {
+  uint16_t seq;          // Numéro de cuisson (0 = emplacement vide)
+  uint8_t progId;        // Empreinte CRC8 des FiringParams utilisés
+  uint8_t endReason;     // HIST_END_*
+  uint16_t peakTarget;   // Température du palier final du programme (°C)
+  uint16_t durationMin;  // Durée totale de la cuisson (minutes)
+  uint16_t maxTemp;      // Température max atteinte (°C)
+  uint8_t overshoot;     // Dépassement max au-dessus de la consigne (°C, saturé à 255)
+  uint8_t rampLag;       // Retard max sous la consigne pendant la chauffe (°C, saturé à 255)
+  uint16_t fullPowerMin; // Temps passé à 100% de puissance (minutes)
+  uint16_t energyMin;    // Énergie en minutes équivalentes pleine puissance (x KILN_POWER_W)
+};
+
+// Function declarations
+void initHistory();
+void historyStartFiring();
+void historyUpdate(float currentTemp, float targetTemp, int maxPower, int averagePower, bool heating, unsigned long currentMillis);
+void historyEndFiring(uint8_t endReason, unsigned long currentMillis);
+uint8_t getHistoryCount();
+bool getHistoryRecord(uint8_t index, FiringRecord &rec); // index 0 = cuisson la plus récente
+#ifdef ENABLE_LOGGING
+void sendHistoryDump();
+#endif
+
+#endif
+
+#endif
@@ -0,0 +1,125 @@
+/*
+ * input.cpp - Entrées utilisateur (encodeur + boutons) par interruptions
+ *
+ * L'encodeur (D2/D3, INT0/INT1) et les boutons (D4/D5, pin change PCINT2)
+ * déposent des événements dans une file circulaire. loop() la vide à chaque
+ * tour : un appui pendant un rafraîchissement d'écran n'est plus perdu.
+ */
+
+#include <Arduino.h>
+#include "input.h"
+
+// Codage d'un événement sur 1 octet : type (bits 7-6), sens négatif (bit 5), accel (bits 4-0)
+#define EVT_TYPE_SHIFT 6
+#define EVT_NEGATIVE 0x20
+#define EVT_ACCEL_MASK 0x1F
+
+// File circulaire : head écrit par les interruptions, tail par loop() (octets = accès atomiques)
+static volatile uint8_t inputQueue[INPUT_QUEUE_SIZE];
+static volatile uint8_t queueHead = 0;
+static volatile uint8_t queueTail = 0;
+
+// Encodeur : état quadrature précédent, sous-pas accumulés (4 par cran), heure du dernier cran
+static volatile uint8_t encoderState = 0;
+static volatile int8_t encoderSteps = 0;
+static volatile unsigned long lastDetentTime = 0;
+
+// Boutons : état stable (HIGH = relâché) et heure du dernier changement accepté
+static const uint8_t buttonPins[2] = {PIN_ENCODER_SW, PIN_PUSH_BUTTON};
+static volatile uint8_t buttonStable[2] = {HIGH, HIGH};
+static volatile unsigned long buttonChangeTime[2] = {0, 0};
+
+// Transitions quadrature (index = nouveau DT, nouveau CLK, ancien DT, ancien CLK)
+// Même convention de sens que la bibliothèque Encoder utilisée auparavant
+static const int8_t QUADRATURE_TABLE[16] PROGMEM = {
+  0, 1, -1, 0, -1, 0, 0, 1, 1, 0, 0, -1, 0, -1, 1, 0
+};
+
+static void pushEvent(uint8_t code) {
+  uint8_t next = (queueHead + 1) & (INPUT_QUEUE_SIZE - 1);
+  if (next == queueTail) return; // File pleine : événement abandonné
+  inputQueue[queueHead] = code;
+  queueHead = next;
+}
+
+static void encoderISR() {
+  uint8_t state = encoderState & 0x03;
+  if (digitalRead(PIN_ENCODER_CLK)) state |= 0x04;
+  if (digitalRead(PIN_ENCODER_DT)) state |= 0x08;
+  encoderSteps += (int8_t)pgm_read_byte(&QUADRATURE_TABLE[state]);
+  encoderState = state >> 2;
+
+  if (encoderSteps >= 4 || encoderSteps <= -4) {
+    bool positive = encoderSteps > 0;
+    encoderSteps += positive ? -4 : 4;
+
+    // Accélération : plus les crans sont rapprochés, plus le pas est grand
+    unsigned long now = millis();
+    unsigned long interval = now - lastDetentTime;
+    lastDetentTime = now;
+    uint8_t accel = 1;
+    if (interval < ENCODER_ACCEL_FAST_MS) accel = 10;
+    else if (interval < ENCODER_ACCEL_MEDIUM_MS) accel = 5;
+    else if (interval < ENCODER_ACCEL_SLOW_MS) accel = 2;
+
+    // Sens inversé pour l'interface (position croissante = delta négatif)
+    pushEvent((EVT_ENCODER << EVT_TYPE_SHIFT) | (positive ? EVT_NEGATIVE : 0) | accel);
+  }
+}
+
+// Accepte un changement d'état hors fenêtre anti-rebond, génère l'événement à l'appui
+static void checkButton(uint8_t index, unsigned long now) {
+  uint8_t state = digitalRead(buttonPins[index]);
+  if (state == buttonStable[index]) return;
+  if (now - buttonChangeTime[index] < BUTTON_DEBOUNCE_MS) return;
+  buttonStable[index] = state;
+  buttonChangeTime[index] = now;
+  if (state == LOW) {
+    InputEventType type = (index == 0) ? EVT_ENCODER_BUTTON : EVT_PUSH_BUTTON;
+    pushEvent(type << EVT_TYPE_SHIFT);
+  }
+}
+
+// Boutons sur le port D (D0-D7) : vecteur PCINT2
+ISR(PCINT2_vect) {
+  unsigned long now = millis();
+  checkButton(0, now);
+  checkButton(1, now);
+}
+
+void initInputs() {
+  pinMode(PIN_ENCODER_CLK, INPUT_PULLUP);
+  pinMode(PIN_ENCODER_DT, INPUT_PULLUP);
+  pinMode(PIN_ENCODER_SW, INPUT_PULLUP);
+  pinMode(PIN_PUSH_BUTTON, INPUT_PULLUP);
+
+  encoderState = (digitalRead(PIN_ENCODER_CLK) ? 0x01 : 0) | (digitalRead(PIN_ENCODER_DT) ? 0x02 : 0);
+  attachInterrupt(digitalPinToInterrupt(PIN_ENCODER_CLK), encoderISR, CHANGE);
+  attachInterrupt(digitalPinToInterrupt(PIN_ENCODER_DT), encoderISR, CHANGE);
+
+  // Interruptions "pin change" pour les deux boutons
+  for (uint8_t i = 0; i < 2; i++) {
+    *digitalPinToPCMSK(buttonPins[i]) |= (1 << digitalPinToPCMSKbit(buttonPins[i]));
+    *digitalPinToPCICR(buttonPins[i]) |= (1 << digitalPinToPCICRbit(buttonPins[i]));
+  }
+}
+
+bool popInputEvent(InputEvent &evt) {
+  if (queueTail == queueHead) return false;
+  uint8_t code = inputQueue[queueTail];
+  queueTail = (queueTail + 1) & (INPUT_QUEUE_SIZE - 1);
+
+  evt.type = (InputEventType)(code >> EVT_TYPE_SHIFT);
+  evt.delta = (code & EVT_NEGATIVE) ? -1 : 1;
+  evt.accel = code & EVT_ACCEL_MASK;
+  return true;
+}
+
+void updateInputs(unsigned long currentMillis) {
+  // Un relâchement (ou appui) tombé dans la fenêtre anti-rebond n'a pas déclenché
+  // de nouvelle interruption : le reprendre ici une fois la fenêtre écoulée
+  noInterrupts();
+  checkButton(0, currentMillis);
+  checkButton(1, currentMillis);
+  interrupts();
+}
@@ -0,0 +1,47 @@
+/*
+ * input.h - Entrées utilisateur (encodeur + boutons) par interruptions
+ */
+
+#ifndef INPUT_H
+#define INPUT_H
+
+#include <Arduino.h>
+
+// Broches fixes : les interruptions utilisées dépendent du port
+#define PIN_ENCODER_CLK 2   // INT0
+#define PIN_ENCODER_DT 3    // INT1
+#define PIN_ENCODER_SW 4    // PCINT20 (port D)
+#define PIN_PUSH_BUTTON 5   // PCINT21 (port D)
+
+// Seul ISR(PCINT2_vect) est défini : un bouton hors port D déclencherait une
+// interruption sans gestionnaire (__bad_interrupt = redémarrage de la carte)
+#if PIN_ENCODER_SW > 7 || PIN_PUSH_BUTTON > 7
+#error "Boutons : broches D0-D7 uniquement (port D, vecteur PCINT2)"
+#endif
+#if (PIN_ENCODER_CLK != 2 && PIN_ENCODER_CLK != 3) || (PIN_ENCODER_DT != 2 && PIN_ENCODER_DT != 3)
+#error "Encodeur : broches D2/D3 uniquement (INT0/INT1)"
+#endif
+
+// File d'événements remplie par les interruptions, vidée par loop()
+#define INPUT_QUEUE_SIZE 16   // Puissance de 2 (1 octet par événement)
+#define BUTTON_DEBOUNCE_MS 30 // Rebonds ignorés après un changement d'état accepté
+
+// Accélération de l'encodeur : multiplicateur selon l'intervalle entre deux crans
+#define ENCODER_ACCEL_FAST_MS 25    // < 25 ms entre crans : x10
+#define ENCODER_ACCEL_MEDIUM_MS 50  // < 50 ms : x5
+#define ENCODER_ACCEL_SLOW_MS 100   // < 100 ms : x2, au-delà : x1
+
+enum InputEventType { EVT_ENCODER, EVT_ENCODER_BUTTON, EVT_PUSH_BUTTON };
+
+struct InputEvent {
+  InputEventType type;
+  int8_t delta;   // EVT_ENCODER : sens du cran (+1/-1, déjà inversé pour l'interface)
+  uint8_t accel;  // EVT_ENCODER : multiplicateur de pas (1 = rotation lente)
+};
+
+// Function declarations
+void initInputs();
+bool popInputEvent(InputEvent &evt);      // false si la file est vide
+void updateInputs(unsigned long currentMillis); // Resynchronise les boutons après la fenêtre anti-rebond
+
+#endif
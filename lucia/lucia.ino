@@ -7,26 +7,21 @@
 #include <SPI.h>
 #include <U8g2lib.h>
 #include <Adafruit_MAX31856.h>
-#include <Encoder.h>
 #include <EEPROM.h>
 #include "definitions.h"
 #include "display.h"
 #include "temperature.h"
+#include "history.h"
+#include "input.h"
 
 // ===== PINS DEFINITION =====
-#define PIN_ENCODER_CLK 2
-#define PIN_ENCODER_DT 3
-#define PIN_ENCODER_SW 4
-#define PIN_PUSH_BUTTON 5
-#define PIN_RELAY 6
-#define PIN_MAX_CS 10
+// Encodeur et boutons : voir input.h (broches imposées par les interruptions)
 #define PIN_LED A1
+// Relais et CS des MAX31856 : par zone, voir ZONE_RELAY_PINS / ZONE_CS_PINS (temperature.h)
 
 // ===== GLOBAL OBJECTS =====
-// Utilise mode 2-page au lieu de full buffer pour économiser ~768 octets de RAM
-U8G2_SH1106_128X64_NONAME_2_HW_I2C u8g2(U8G2_R0, U8X8_PIN_NONE);
-Adafruit_MAX31856 max31856 = Adafruit_MAX31856(PIN_MAX_CS);
-Encoder encoder(PIN_ENCODER_CLK, PIN_ENCODER_DT);
+// Mode 2-page par défaut (économise ~768 octets de RAM), full buffer avec ENABLE_FULL_BUFFER
+DisplayDriver u8g2(U8G2_R0, U8X8_PIN_NONE);
 
 // ===== PROGRAM STATE =====
 ProgramState progState = PROG_OFF;
@@ -34,53 +29,54 @@ Phase currentPhase = PHASE_0;
 
 // ===== FIRING PROGRAM PARAMETERS =====
 FiringParams params = {100, 50, 5, 570, 250, 15, 1100, 200, 20, 150, 200};
-FiringParams paramsBackup; // Sauvegarde pour détecter les changements
 
 // ===== SETTINGS PARAMETERS =====
-SettingsParams settings = {1000, 2.5, 0.03, 0.0, 10, 1200}; // pcycle (ms), kp, ki, kd (non utilisé), maxDelta (°C), maxTemp (°C)
-SettingsParams settingsBackup; // Sauvegarde pour détecter les changements
+SettingsParams settings = {1000, 2.5, 0.03, 0.0, 10, 1200, 0}; // pcycle (ms), kp, ki, kd (non utilisé), maxDelta (°C), maxTemp (°C), smoothing (°C)
 int selectedSetting = 0;
-const int NUM_SETTINGS = 6; // Heat Cycle, Kp, Ki, Max delta, Max Temp, Exit
+#ifdef ENABLE_HISTORY
+const int NUM_SETTINGS = 8; // Heat Cycle, Kp, Ki, Max delta, Max Temp, Smooth, History, Exit
+#define SETTING_HISTORY 6
+#else
+const int NUM_SETTINGS = 7; // Heat Cycle, Kp, Ki, Max delta, Max Temp, Smooth, Exit
+#endif
 int settingsScrollOffset = 0; // Scroll pour l'écran settings
+#ifdef ENABLE_HISTORY
+int selectedHistory = 0; // Cuisson affichée (0 = la plus récente)
+#endif
 
 // ===== UI PARAMETERS =====
 EditMode editMode = NAV_MODE;
 int selectedParam = 2; // Sélectionne step1Temp par défaut (Settings=0, step1Speed=1, step1Temp=2)
 const int NUM_PARAMS = 12; // 12 paramètres (Settings + 11 paramètres de phases)
-long encoderPosition = 0;
 
 // ===== TIMING VARIABLES =====
-unsigned long lastDisplayUpdate = 0;
+// Horodatages d'intervalles courts sur 16 bits (voir elapsed16)
+uint16_t lastDisplayUpdate = 0;
 unsigned long programStartTime = 0;
 unsigned long phaseStartTime = 0;
 unsigned long plateauStartTime = 0;
 unsigned long tempFailStartTime = 0;
-bool tempFailActive = false;
-unsigned long lastTempRead = 0;
+uint16_t lastTempRead = 0;
 float cachedTemperature = NAN;
 #ifdef ENABLE_GRAPH
-unsigned long lastGraphUpdate = 0;
+uint16_t lastGraphUpdate = 0;
 #endif
 #ifdef ENABLE_LOGGING
-unsigned long lastDataLog = 0;
+uint16_t lastDataLog = 0;
 #endif
 
 // ===== EEPROM PROTECTION =====
 unsigned long lastEEPROMWrite = 0;
-bool eepromWriteAllowed = true;  // Permettre la première écriture au démarrage
 
-// ===== BUTTON STATES =====
-bool lastEncoderButton = HIGH;
-bool lastPushButton = HIGH;
-#ifdef ENABLE_GRAPH
-bool showGraph = false;
-#endif
-bool criticalErrorActive = false;
+
+// ===== RUNTIME FLAGS =====
+// tempFailActive, criticalErrorActive, plateauReached, eepromWriteAllowed (première écriture
+// permise), showGraph
+RuntimeFlags flags = {false, false, false, true, false};
 
 // ===== TEMPERATURE CONTROL =====
 float targetTemp = 0;
 float phaseStartTemp = 0;  // Température de départ de la phase en cours
-bool plateauReached = false;
 
 // ===== EEPROM ADDRESSES =====
 #define EEPROM_MAGIC 0x4C55  // "LU" magic number to detect first use
@@ -89,14 +85,13 @@ bool plateauReached = false;
 
 // ===== GRAPH DATA =====
 #ifdef ENABLE_GRAPH
-// Implémentation optimisée avec décimation adaptative (256 octets)
-uint8_t graphTempRead[GRAPH_SIZE];
-uint8_t graphTempTarget[GRAPH_SIZE];
-uint16_t graphTimeStamps[GRAPH_SIZE];
-uint8_t graphIndex = 0;
-uint8_t graphCount = 0;
-uint16_t samplingInterval = 5;
-uint16_t nextSamplingTime = 5;
+// Enveloppe min/max/dernier par bucket (252 octets) : les buckets couvrent toujours
+// toute la cuisson et fusionnent deux à deux quand le buffer est plein
+uint8_t graphMin[GRAPH_SIZE];
+uint8_t graphMax[GRAPH_SIZE];
+uint8_t graphLast[GRAPH_SIZE];
+uint8_t graphCount = 0;                      // Buckets utilisés (le dernier est en cours)
+uint16_t graphBucketSpan = GRAPH_MIN_SPAN;  // Durée d'un bucket (secondes)
 #endif
 
 void setup() {
@@ -106,20 +101,17 @@ void setup() {
   #endif
   
   // Initialize pins
-  pinMode(PIN_ENCODER_SW, INPUT_PULLUP);
-  pinMode(PIN_PUSH_BUTTON, INPUT_PULLUP);
-  pinMode(PIN_RELAY, OUTPUT);
-  pinMode(PIN_LED, OUTPUT);
-  digitalWrite(PIN_RELAY, LOW);
-  digitalWrite(PIN_LED, LOW);
+  initInputs();
+  
+  // Relais de toutes les zones OFF dès le démarrage (+ LED)
+  initTemperatureControl();
   
   // Initialize display
   u8g2.begin();
   u8g2.setContrast(255);
   
-  // Initialize SPI for MAX31856 (CRITICAL: must be before max31856.begin())
-  pinMode(PIN_MAX_CS, OUTPUT);
-  digitalWrite(PIN_MAX_CS, HIGH); // CS doit être HIGH quand non utilisé
+  // Initialize SPI for MAX31856 (CRITICAL: must be before beginThermocouples())
+  initThermocouplePins();
   SPI.begin();
   
   // Attente non-bloquante pour stabilisation SPI (100ms)
@@ -128,20 +120,17 @@ void setup() {
     // Attente active pour stabilisation
   }
   
-  // Initialize MAX31856
-  if (!max31856.begin()) {
-    criticalErrorActive = true;
+  // Initialize MAX31856 (toutes les zones)
+  if (!beginThermocouples()) {
+    flags.criticalErrorActive = true;
     u8g2.clearBuffer();
     u8g2.setFont(u8g2_font_6x10_tf);
-    u8g2.drawStr(0, 20, "MAX31856 Error!");
-    u8g2.drawStr(0, 35, "Check wiring");
-    u8g2.drawStr(0, 50, "Press to retry");
+    drawStrF(0, 20, F("MAX31856 Error!"));
+    drawStrF(0, 35, F("Check wiring"));
+    drawStrF(0, 50, F("Press to retry"));
     u8g2.sendBuffer();
     // Ne pas bloquer, gérer dans loop()
   } else {
-    max31856.setThermocoupleType(MAX31856_TCTYPE_S);
-    max31856.setConversionMode(MAX31856_CONTINUOUS);
-    
     // Attente non-bloquante pour la première conversion (500ms)
     unsigned long conversionStartTime = millis();
     while (millis() - conversionStartTime < 500) {
@@ -161,11 +150,10 @@ void setup() {
   settings.kp = KP;
   settings.ki = KI;
   // settings.kd reste à 0.0 (non utilisé, mais gardé pour compatibilité EEPROM)
-  // Mettre à jour le backup après synchronisation
-  settingsBackup = settings;
   
-  // Initialize temperature control
-  initTemperatureControl();
+  #ifdef ENABLE_HISTORY
+  initHistory();
+  #endif
   
   updateDisplay(0);
   #ifdef ENABLE_LOGGING
@@ -177,167 +165,190 @@ void loop() {
   unsigned long currentMillis = millis();
   
   // Gestion de l'erreur critique MAX31856 (si détectée au setup)
-  if (criticalErrorActive) {
-    // Attendre un appui sur le bouton pour retry
-    bool pushButton = digitalRead(PIN_PUSH_BUTTON);
-    if (pushButton == LOW && lastPushButton == HIGH) {
-      // Tentative de réinitialisation du MAX31856
-      if (max31856.begin()) {
-        max31856.setThermocoupleType(MAX31856_TCTYPE_S);
-        max31856.setConversionMode(MAX31856_CONTINUOUS);
-        criticalErrorActive = false;
+  if (flags.criticalErrorActive) {
+    // Attendre un appui sur le bouton pour retry (autres événements ignorés)
+    updateInputs(currentMillis);
+    InputEvent evt;
+    while (popInputEvent(evt)) {
+      if (evt.type == EVT_PUSH_BUTTON && beginThermocouples()) {
+        // Réinitialisation du MAX31856 réussie
+        flags.criticalErrorActive = false;
         cachedTemperature = readTemperature();
         lastTempRead = currentMillis;
       }
     }
-    lastPushButton = pushButton;
     return; // Ne rien faire d'autre tant que l'erreur n'est pas résolue
   }
   
-  // Lecture température (intervalle défini pour optimiser les performances)
-  float temp;
-  if (currentMillis - lastTempRead >= TEMP_READ_INTERVAL) {
-    temp = readTemperature();
-    cachedTemperature = temp;
+  // Lecture température : une zone par créneau (lectures SPI décalées),
+  // chaque zone est relue toutes les TEMP_READ_INTERVAL ms
+  if (elapsed16(currentMillis, lastTempRead) >= TEMP_READ_INTERVAL / ZONE_COUNT) {
+    readNextZone();
+    cachedTemperature = getAverageTemperature();
     lastTempRead = currentMillis;
-  } else {
-    temp = cachedTemperature; // Utiliser la dernière valeur lue
   }
+  float temp = cachedTemperature; // Moyenne des zones (température de conduite du programme)
   
-  // Vérification des erreurs de lecture température
-  if (isnan(temp) || temp < -100 || temp > 1500) {
-    if (!tempFailActive) {
-      tempFailActive = true;
+  // Vérification des erreurs de lecture température (chaque zone, pas seulement la moyenne)
+  if (!zoneTemperaturesValid()) {
+    if (!flags.tempFailActive) {
+      flags.tempFailActive = true;
       tempFailStartTime = currentMillis;
     } else if (currentMillis - tempFailStartTime > TEMP_FAIL_TIMEOUT) {
       // Erreur critique - arrêt du chauffage pour sécurité
       if (progState == PROG_ON) {
+        #ifdef ENABLE_HISTORY
+        historyEndFiring(HIST_END_SENSOR, currentMillis);
+        #endif
         progState = PROG_OFF;
         currentPhase = PHASE_0;
         setRelay(false);
       }
-      tempFailActive = false; // Réinitialiser pour permettre une nouvelle tentative
+      flags.tempFailActive = false; // Réinitialiser pour permettre une nouvelle tentative
     }
   } else {
-    tempFailActive = false;
+    flags.tempFailActive = false;
   }
   
-  // Gestion des boutons
-  handleButtons(currentMillis);
-  
-  // Gestion de l'encodeur (intervalle optimisé pour réduire la charge CPU)
-  #ifdef ENABLE_GRAPH
-  bool canUseEncoder = (progState == PROG_OFF || progState == SETTINGS) && !showGraph;
-  #else
-  bool canUseEncoder = (progState == PROG_OFF || progState == SETTINGS);
-  #endif
-  if (canUseEncoder) {
-    static unsigned long lastEncoderCheck = 0;
-    if (currentMillis - lastEncoderCheck >= ENCODER_CHECK_INTERVAL) {
-      handleEncoder();
-      lastEncoderCheck = currentMillis;
-    }
+  // Entrées utilisateur : vider la file remplie par les interruptions
+  // (latence indépendante du temps de rendu de l'écran)
+  updateInputs(currentMillis);
+  InputEvent evt;
+  while (popInputEvent(evt)) {
+    handleInputEvent(evt);
   }
   
   // Mise à jour de l'état du programme
   if (progState == PROG_ON) {
     updateProgram(currentMillis, temp);
+    #ifdef ENABLE_HISTORY
+    historyUpdate(temp, targetTemp, getPowerHold(), getAveragePowerHold(), currentPhase != PHASE_4_COOLDOWN, currentMillis);
+    #endif
     #ifdef ENABLE_GRAPH
     updateGraphData(currentMillis, temp);
     #endif
     #ifdef ENABLE_LOGGING
-    if (currentMillis - lastDataLog >= 5000) {
+    if (elapsed16(currentMillis, lastDataLog) >= 5000) {
       sendDataLog(currentMillis, temp);
       lastDataLog = currentMillis;
     }
     #endif
   }
   
+  #if defined(ENABLE_LOGGING) && defined(ENABLE_HISTORY)
+  // Commande 'H' sur le port série : export de l'historique des cuissons
+  // Ignorée pendant une cuisson : l'export bloque loop() ~0,8 s à 9600 bauds (PWM, PID, lectures)
+  if (Serial.available() && Serial.read() == 'H' && progState != PROG_ON) {
+    sendHistoryDump();
+  }
+  #endif
+  
   // Mise à jour de l'affichage
-  if (currentMillis - lastDisplayUpdate >= DISPLAY_UPDATE_INTERVAL) {
+  if (elapsed16(currentMillis, lastDisplayUpdate) >= DISPLAY_UPDATE_INTERVAL) {
     lastDisplayUpdate = currentMillis;
     updateDisplay(currentMillis);
   }
   
   // Mise à jour du contrôle de température
-  updateTemperatureControl(temp, targetTemp, progState == PROG_ON, currentMillis);
+  updateTemperatureControl(targetTemp, progState == PROG_ON, currentMillis);
 }
 
-void handleButtons(unsigned long currentMillis) {
-  // Gestion du bouton encodeur
-  bool encoderButton = digitalRead(PIN_ENCODER_SW);
-  
-  if (encoderButton == LOW && lastEncoderButton == HIGH) {
-    // Appui détecté - exécuter l'action immédiatement
-    if (progState == PROG_ON) {
+// Traitement d'un événement de la file d'entrées (appelé depuis loop())
+void handleInputEvent(const InputEvent &evt) {
+  switch (evt.type) {
+    case EVT_ENCODER_BUTTON:
+      handleEncoderButton();
+      break;
+    case EVT_PUSH_BUTTON:
+      toggleProgState();
+      break;
+    case EVT_ENCODER: {
       #ifdef ENABLE_GRAPH
-      showGraph = !showGraph;
+      bool canUseEncoder = (progState == PROG_OFF || progState == SETTINGS || progState == HISTORY) && !flags.showGraph;
+      #else
+      bool canUseEncoder = (progState == PROG_OFF || progState == SETTINGS || progState == HISTORY);
       #endif
-    } else if (progState == PROG_OFF) {
-      if (selectedParam == 0 && editMode == NAV_MODE) {
-        progState = SETTINGS;
-        selectedSetting = 0;
-        editMode = NAV_MODE;
-      } else {
-        toggleEditMode();
-      }
-    } else if (progState == SETTINGS) {
-      if (selectedSetting == 5) {  // Exit est à l'index 5
-        progState = PROG_OFF;
-        selectedParam = 2; // Retour sur step1Temp par défaut
-        editMode = NAV_MODE;
-      } else {
-        toggleSettingsEditMode();
-      }
+      if (canUseEncoder) handleEncoder(evt);
+      break;
     }
   }
-  
-  lastEncoderButton = encoderButton;
-  
-  // Gestion du bouton push
-  bool pushButton = digitalRead(PIN_PUSH_BUTTON);
-  
-  if (pushButton == LOW && lastPushButton == HIGH) {
-    // Appui détecté - exécuter l'action immédiatement
-    toggleProgState();
+}
+
+void handleEncoderButton() {
+  if (progState == PROG_ON) {
+    #ifdef ENABLE_GRAPH
+    flags.showGraph = !flags.showGraph;
+    #endif
+  } else if (progState == PROG_OFF) {
+    if (selectedParam == 0 && editMode == NAV_MODE) {
+      progState = SETTINGS;
+      selectedSetting = 0;
+      editMode = NAV_MODE;
+    } else {
+      toggleEditMode();
+    }
+  } else if (progState == SETTINGS) {
+    if (selectedSetting == NUM_SETTINGS - 1) {  // Exit est toujours le dernier
+      progState = PROG_OFF;
+      selectedParam = 2; // Retour sur step1Temp par défaut
+      editMode = NAV_MODE;
+    }
+    #ifdef ENABLE_HISTORY
+    else if (selectedSetting == SETTING_HISTORY && editMode == NAV_MODE) {
+      progState = HISTORY;
+      selectedHistory = 0;
+    }
+    #endif
+    else {
+      toggleSettingsEditMode();
+    }
   }
-  
-  lastPushButton = pushButton;
+  #ifdef ENABLE_HISTORY
+  else if (progState == HISTORY) {
+    progState = SETTINGS; // Retour sur l'entrée History
+  }
+  #endif
 }
 
-void handleEncoder() {
-  long newPosition = encoder.read() / 4;
+void handleEncoder(const InputEvent &evt) {
+  // Navigation : un cran = un élément. Édition : pas accéléré selon la vitesse de rotation
+  int delta = evt.delta;
+  int editDelta = evt.delta * evt.accel;
+  
+  #ifdef ENABLE_HISTORY
+  if (progState == HISTORY) {
+    // Parcourir les cuissons enregistrées (sans boucler)
+    selectedHistory += delta;
+    if (selectedHistory >= getHistoryCount()) selectedHistory = getHistoryCount() - 1;
+    if (selectedHistory < 0) selectedHistory = 0;
+    return;
+  }
+  #endif
   
-  if (newPosition != encoderPosition) {
-    // Inverser le sens du delta pour inverser la direction de défilement
-    int delta = encoderPosition - newPosition;
-    encoderPosition = newPosition;
-    
-    if (progState == SETTINGS) {
-      // Gérer l'encodeur dans l'écran settings
-      if (editMode == NAV_MODE) {
-        // Navigate between settings (sans boucler)
-        selectedSetting += delta;
-        // Limiter aux bornes sans boucler
-        if (selectedSetting < 0) selectedSetting = 0;
-        if (selectedSetting >= NUM_SETTINGS) selectedSetting = NUM_SETTINGS - 1;
-      } else {
-        // Edit selected setting
-        editSetting(delta);
-      }
-    } else if (progState == PROG_OFF) {
-      // Gérer l'encodeur dans l'écran phase 0
-      if (editMode == NAV_MODE) {
-        // Navigate between parameters (sans boucler)
-        selectedParam += delta;
-        // Limiter aux bornes sans boucler
-        if (selectedParam < 0) selectedParam = 0;
-        if (selectedParam >= NUM_PARAMS) selectedParam = NUM_PARAMS - 1;
-      } else {
-        // Edit selected parameter (mais pas Settings qui est à l'index 0)
-        if (selectedParam != 0) {
-          editParameter(delta);
-        }
+  if (progState == SETTINGS) {
+    // Gérer l'encodeur dans l'écran settings
+    if (editMode == NAV_MODE) {
+      // Navigate between settings (sans boucler)
+      selectedSetting += delta;
+      // Limiter aux bornes sans boucler
+      if (selectedSetting < 0) selectedSetting = 0;
+      if (selectedSetting >= NUM_SETTINGS) selectedSetting = NUM_SETTINGS - 1;
+    } else {
+      // Edit selected setting
+      editSetting(editDelta);
+    }
+  } else if (progState == PROG_OFF) {
+    // Gérer l'encodeur dans l'écran phase 0
+    if (editMode == NAV_MODE) {
+      // Navigate between parameters (sans boucler)
+      selectedParam += delta;
+      // Limiter aux bornes sans boucler
+      if (selectedParam < 0) selectedParam = 0;
+      if (selectedParam >= NUM_PARAMS) selectedParam = NUM_PARAMS - 1;
+    } else {
+      // Edit selected parameter (mais pas Settings qui est à l'index 0)
+      if (selectedParam != 0) {
+        editParameter(editDelta);
       }
     }
   }
@@ -346,8 +357,6 @@ void handleEncoder() {
 void toggleEditMode() {
   if (editMode == NAV_MODE) {
     editMode = EDIT_MODE;
-    // Sauvegarder les valeurs actuelles pour détecter les changements
-    paramsBackup = params;
   } else {
     editMode = NAV_MODE;
     // Sauvegarder seulement si les paramètres ont changé
@@ -358,8 +367,6 @@ void toggleEditMode() {
 void toggleSettingsEditMode() {
   if (editMode == NAV_MODE) {
     editMode = EDIT_MODE;
-    // Sauvegarder les valeurs actuelles pour détecter les changements
-    settingsBackup = settings;
   } else {
     editMode = NAV_MODE;
     // Sauvegarder seulement si les settings ont changé
@@ -397,23 +404,27 @@ void editSetting(int delta) {
       if (settings.maxTemp < 500) settings.maxTemp = 500;
       if (settings.maxTemp > 1500) settings.maxTemp = 1500;
       break;
-    case 5: // Exit - ne rien faire, géré par le bouton
+    case 5: // Smooth - fenêtre d'arrondi avant chaque palier
+      settings.smoothing += delta * 1; // Incrément de 1°C
+      if (settings.smoothing < 0) settings.smoothing = 0;
+      if (settings.smoothing > 100) settings.smoothing = 100;
+      break;
+    default: // History / Exit - ne rien faire, géré par le bouton
       break;
   }
 }
 
 void saveSettingsToEEPROM() {
   unsigned long currentMillis = millis();
-  if (!eepromWriteAllowed && (currentMillis - lastEEPROMWrite < EEPROM_WRITE_MIN_INTERVAL)) return;
+  if (!flags.eepromWriteAllowed && (currentMillis - lastEEPROMWrite < EEPROM_WRITE_MIN_INTERVAL)) return;
   EEPROM.put(EEPROM_ADDR_PARAMS + sizeof(FiringParams), settings);
   lastEEPROMWrite = currentMillis;
-  eepromWriteAllowed = false;
+  flags.eepromWriteAllowed = false;
 }
 
 void saveSettingsToEEPROMIfChanged() {
-  if (memcmp(&settings, &settingsBackup, sizeof(SettingsParams)) != 0) {
+  if (eepromDiffers(EEPROM_ADDR_PARAMS + sizeof(FiringParams), &settings, sizeof(SettingsParams))) {
     saveSettingsToEEPROM();
-    settingsBackup = settings;
   }
 }
 
@@ -422,10 +433,13 @@ void toggleProgState() {
     progState = PROG_ON;
     unsigned long now = millis();
     programStartTime = phaseStartTime = now;
+    #ifdef ENABLE_HISTORY
+    historyStartFiring();
+    #endif
     #ifdef ENABLE_GRAPH
     lastGraphUpdate = now;
     #endif
-    plateauReached = false;
+    flags.plateauReached = false;
     
     float t = readTemperature();
     targetTemp = t;
@@ -453,8 +467,8 @@ void toggleProgState() {
     }
     
     #ifdef ENABLE_GRAPH
-    graphIndex = graphCount = 0;
-    samplingInterval = nextSamplingTime = 5;
+    graphCount = 0;
+    graphBucketSpan = GRAPH_MIN_SPAN;
     #endif
     resetPID();
     
@@ -465,12 +479,17 @@ void toggleProgState() {
     #ifdef ENABLE_LOGGING
     sendProgramStopLog();
     #endif
+    #ifdef ENABLE_HISTORY
+    if (progState == PROG_ON) {
+      historyEndFiring(HIST_END_STOPPED, millis());
+    }
+    #endif
     
     progState = PROG_OFF;
     currentPhase = PHASE_0;
     setRelay(false);
     #ifdef ENABLE_GRAPH
-    showGraph = false;
+    flags.showGraph = false;
     #endif
   }
 }
@@ -512,33 +531,33 @@ void updateProgram(unsigned long currentMillis, float currentTemp) {
     case PHASE_1:
       // Utilise phaseStartTemp (température initiale) au lieu de currentTemp
       targetTemp = calculateTargetTemp(phaseStartTemp, params.step1Temp, params.step1Speed, phaseElapsed);
-      if (checkPhaseComplete(currentTemp, params.step1Temp, plateauReached, plateauStartTime, params.step1Wait, currentMillis)) {
+      if (checkPhaseComplete(currentTemp, targetTemp, params.step1Temp, params.step1Wait, currentMillis)) {
         currentPhase = PHASE_2;
         phaseStartTime = currentMillis;
         phaseStartTemp = params.step1Temp;  // Départ = cible du palier précédent
-        plateauReached = false;
+        flags.plateauReached = false;
       }
       break;
       
     case PHASE_2:
       // Utilise phaseStartTemp (step1Temp) au lieu de currentTemp
       targetTemp = calculateTargetTemp(phaseStartTemp, params.step2Temp, params.step2Speed, phaseElapsed);
-      if (checkPhaseComplete(currentTemp, params.step2Temp, plateauReached, plateauStartTime, params.step2Wait, currentMillis)) {
+      if (checkPhaseComplete(currentTemp, targetTemp, params.step2Temp, params.step2Wait, currentMillis)) {
         currentPhase = PHASE_3;
         phaseStartTime = currentMillis;
         phaseStartTemp = params.step2Temp;  // Départ = cible du palier précédent
-        plateauReached = false;
+        flags.plateauReached = false;
       }
       break;
       
     case PHASE_3:
       // Utilise phaseStartTemp (step2Temp) au lieu de currentTemp
       targetTemp = calculateTargetTemp(phaseStartTemp, params.step3Temp, params.step3Speed, phaseElapsed);
-      if (checkPhaseComplete(currentTemp, params.step3Temp, plateauReached, plateauStartTime, params.step3Wait, currentMillis)) {
+      if (checkPhaseComplete(currentTemp, targetTemp, params.step3Temp, params.step3Wait, currentMillis)) {
         currentPhase = PHASE_4_COOLDOWN;
         phaseStartTime = currentMillis;
         phaseStartTemp = params.step3Temp;  // Départ = cible du palier précédent
-        plateauReached = false;
+        flags.plateauReached = false;
       }
       break;
       
@@ -546,6 +565,9 @@ void updateProgram(unsigned long currentMillis, float currentTemp) {
       // Utilise phaseStartTemp (step3Temp) au lieu de currentTemp
       targetTemp = calculateCoolingTarget(phaseStartTemp, params.step4Target, params.step4Speed, phaseElapsed);
       if (currentTemp <= params.step4Target) {
+        #ifdef ENABLE_HISTORY
+        historyEndFiring(HIST_END_DONE, currentMillis);
+        #endif
         progState = PROG_OFF;
         currentPhase = PHASE_0;
         setRelay(false);
@@ -560,7 +582,21 @@ float calculateTargetTemp(float startTemp, int targetTemp, int speed, unsigned l
   // Utilisation de float pour avoir une progression continue (pas de sauts de 1°C)
   float tempIncrease = (float)speed * (float)elapsed / 3600000.0;
   float calculatedTarget = startTemp + tempIncrease;
-  return (calculatedTarget > targetTemp) ? (float)targetTemp : calculatedTarget;
+  
+  // Arrondi de l'arrivée au palier : au lieu du coin vif (rampe puis consigne figée),
+  // la consigne décélère à taux constant sur les derniers "smoothing" °C.
+  // Raccord sans saut de pente, durée finie (2x la durée de la rampe linéaire sur la fenêtre)
+  float window = settings.smoothing;
+  if (window > targetTemp - startTemp) window = targetTemp - startTemp;
+  if (window <= 0 || speed <= 0 || calculatedTarget < targetTemp - window) {
+    return (calculatedTarget > targetTemp) ? (float)targetTemp : calculatedTarget;
+  }
+  
+  // Temps passé dans la zone d'arrondi, en heures (rampe à pleine vitesse jusqu'à targetTemp - window)
+  float blendTime = 2.0 * window / speed;
+  float t = (calculatedTarget - (targetTemp - window)) / speed;
+  if (t >= blendTime) return (float)targetTemp;
+  return targetTemp - window + speed * t - speed * t * t / (2.0 * blendTime);
 }
 
 float calculateCoolingTarget(float startTemp, int targetTemp, int speed, unsigned long elapsed) {
@@ -572,13 +608,17 @@ float calculateCoolingTarget(float startTemp, int targetTemp, int speed, unsigne
   return (calculatedTarget < targetTemp) ? (float)targetTemp : calculatedTarget;
 }
 
-bool checkPhaseComplete(float currentTemp, int phaseTemp, bool &reached, unsigned long &plateauStart, int waitMinutes, unsigned long currentMillis) {
-  // Vérifier si la température est dans la tolérance (maxDelta en dessous) ET au-dessus de la cible
-  if (!reached && currentTemp >= (phaseTemp - settings.maxDelta) && currentTemp >= phaseTemp) {
-    reached = true;
-    plateauStart = currentMillis;
+bool checkPhaseComplete(float currentTemp, float targetTemp, int phaseTemp, int waitMinutes, unsigned long currentMillis) {
+  // Sans arrondi : la température doit atteindre la cible du palier
+  // Avec arrondi : la consigne arrondie doit être arrivée au palier et la température dans la tolérance
+  // (maxDelta en dessous), le four approchant la cible par en dessous sans la dépasser
+  // flags.plateauReached est un champ de bits : mis à jour ici plutôt que passé par référence
+  bool reached = (settings.smoothing > 0) ? (targetTemp >= phaseTemp) : (currentTemp >= phaseTemp);
+  if (!flags.plateauReached && reached && currentTemp >= (phaseTemp - settings.maxDelta)) {
+    flags.plateauReached = true;
+    plateauStartTime = currentMillis;
   }
-  if (reached && (currentMillis - plateauStart) >= (unsigned long)waitMinutes * 60000UL) {
+  if (flags.plateauReached && (currentMillis - plateauStartTime) >= (unsigned long)waitMinutes * 60000UL) {
     return true;
   }
   return false;
@@ -591,25 +631,43 @@ uint8_t tempToUint8(float temp) {
   return (uint8_t)(temp * 0.199);  // 255/1280 ≈ 0.199
 }
 
+// Fusionne les buckets deux à deux : la moitié du buffer se libère, la durée double
+void compactGraphData() {
+  uint8_t half = (graphCount + 1) / 2;
+  for (uint8_t i = 0; i < half; i++) {
+    uint8_t a = 2 * i;
+    uint8_t b = (a + 1 < graphCount) ? a + 1 : a;
+    graphMin[i] = min(graphMin[a], graphMin[b]);
+    graphMax[i] = max(graphMax[a], graphMax[b]);
+    graphLast[i] = graphLast[b];
+  }
+  graphCount = half;
+  graphBucketSpan *= 2;
+}
+
 void updateGraphData(unsigned long currentMillis, float temp) {
-  uint16_t elapsed = (currentMillis - programStartTime) / 1000;
-  if (elapsed < nextSamplingTime) return;
-  
-  graphTempRead[graphIndex] = tempToUint8(temp);
-  graphTempTarget[graphIndex] = tempToUint8(targetTemp);
-  graphTimeStamps[graphIndex] = elapsed;
-  
-  if (++graphIndex >= GRAPH_SIZE) graphIndex = 0;
-  if (graphCount < GRAPH_SIZE) graphCount++;
-  
-  nextSamplingTime = elapsed + samplingInterval;
+  // Échantillonnage à 1 Hz : chaque mesure alimente le min/max de son bucket
+  if (elapsed16(currentMillis, lastGraphUpdate) < 1000) return;
+  lastGraphUpdate = currentMillis;
+  if (isnan(temp)) return;
+  
+  // Le bucket est déduit du temps écoulé : pas d'horodatage stocké, pas de débordement
+  unsigned long elapsed = (currentMillis - programStartTime) / 1000;
+  while (elapsed / graphBucketSpan >= GRAPH_SIZE) {
+    compactGraphData();
+  }
+  uint8_t bucket = elapsed / graphBucketSpan;
+  uint8_t value = tempToUint8(temp);
   
-  static uint8_t cnt = 0;
-  if (++cnt >= 20 && samplingInterval < 60) {
-    samplingInterval += 5;
-    if (samplingInterval > 60) samplingInterval = 60;
-    cnt = 0;
+  // Nouveau bucket (et buckets sautés éventuels) : initialiser avec la mesure
+  while (graphCount <= bucket) {
+    graphMin[graphCount] = graphMax[graphCount] = graphLast[graphCount] = value;
+    graphCount++;
   }
+  
+  if (value < graphMin[bucket]) graphMin[bucket] = value;
+  if (value > graphMax[bucket]) graphMax[bucket] = value;
+  graphLast[bucket] = value;
 }
 #endif
 
@@ -617,21 +675,27 @@ void updateDisplay(unsigned long currentMillis) {
   u8g2.firstPage();
   do {
     #ifdef ENABLE_GRAPH
-    if (showGraph && progState == PROG_ON) {
+    if (flags.showGraph && progState == PROG_ON) {
       drawGraph();
     } else
     #endif
-    if (tempFailActive && (currentMillis - tempFailStartTime > TEMP_FAIL_TIMEOUT)) {
+    if (flags.tempFailActive && (currentMillis - tempFailStartTime > TEMP_FAIL_TIMEOUT)) {
       // Afficher l'erreur critique de température
       u8g2.setFont(u8g2_font_6x10_tf);
-      u8g2.drawStr(0, 10, "ERROR!");
-      u8g2.drawStr(0, 25, "Temp fail 2min");
-      u8g2.drawStr(0, 40, "Heat stopped");
-      u8g2.drawStr(0, 55, "Check sensor");
+      drawStrF(0, 10, F("ERROR!"));
+      drawStrF(0, 25, F("Temp fail 2min"));
+      drawStrF(0, 40, F("Heat stopped"));
+      drawStrF(0, 55, F("Check sensor"));
     } else {
       if (progState == SETTINGS) {
         drawSettingsScreen();
-      } else if (progState == PROG_OFF) {
+      }
+      #ifdef ENABLE_HISTORY
+      else if (progState == HISTORY) {
+        drawHistoryScreen();
+      }
+      #endif
+      else if (progState == PROG_OFF) {
         drawProgOffScreen();
       } else {
         drawProgOnScreen(currentMillis);
@@ -642,17 +706,25 @@ void updateDisplay(unsigned long currentMillis) {
 
 void saveToEEPROM() {
   unsigned long currentMillis = millis();
-  if (!eepromWriteAllowed && (currentMillis - lastEEPROMWrite < EEPROM_WRITE_MIN_INTERVAL)) return;
+  if (!flags.eepromWriteAllowed && (currentMillis - lastEEPROMWrite < EEPROM_WRITE_MIN_INTERVAL)) return;
   EEPROM.put(EEPROM_ADDR_MAGIC, EEPROM_MAGIC);
   EEPROM.put(EEPROM_ADDR_PARAMS, params);
   lastEEPROMWrite = currentMillis;
-  eepromWriteAllowed = false;
+  flags.eepromWriteAllowed = false;
+}
+
+// Compare une structure RAM avec son image en EEPROM (remplace les copies de sauvegarde en RAM)
+bool eepromDiffers(int address, const void* data, size_t size) {
+  const uint8_t* bytes = (const uint8_t*)data;
+  for (size_t i = 0; i < size; i++) {
+    if (EEPROM.read(address + i) != bytes[i]) return true;
+  }
+  return false;
 }
 
 void saveToEEPROMIfChanged() {
-  if (memcmp(&params, &paramsBackup, sizeof(FiringParams)) != 0) {
+  if (eepromDiffers(EEPROM_ADDR_PARAMS, &params, sizeof(FiringParams))) {
     saveToEEPROM();
-    paramsBackup = params;
   }
 }
 
@@ -662,7 +734,7 @@ void saveAllToEEPROM() {
   EEPROM.put(EEPROM_ADDR_PARAMS, params);
   EEPROM.put(EEPROM_ADDR_PARAMS + sizeof(FiringParams), settings);
   lastEEPROMWrite = millis();
-  eepromWriteAllowed = false;
+  flags.eepromWriteAllowed = false;
 }
 
 void loadFromEEPROM() {
@@ -681,6 +753,7 @@ void loadFromEEPROM() {
     settings.maxDelta = constrain(settings.maxDelta, 1, 50);
     settings.maxTemp = constrain(settings.maxTemp, 500, 1500);
     if (settings.maxTemp == 0) settings.maxTemp = 1200;  // Valeur par défaut si EEPROM vide
+    settings.smoothing = constrain(settings.smoothing, 0, 100);  // EEPROM antérieure : 0xFFFF -> 0 (désactivé)
     
     CYCLE_LENGTH = settings.pcycle;
     KP = settings.kp;
@@ -689,8 +762,6 @@ void loadFromEEPROM() {
   } else {
     saveAllToEEPROM();
   }
-  paramsBackup = params;
-  settingsBackup = settings;
 }
 
 // Fonction pour obtenir la température mise en cache (lue toutes les 500ms dans loop())
@@ -706,24 +777,57 @@ void sendStartupLog() {
   Serial.print(KP);
   Serial.print(F(" Ki="));
   Serial.println(KI);
+  #if ZONE_COUNT > 1
+  // 7 premières colonnes = moyennes des zones (compatibles avec le logger),
+  // puis température et puissance de chaque zone
+  Serial.print(F("Time(ms), Temp(C), Target(C), P, I, Power(%), Error(C)"));
+  for (uint8_t z = 1; z <= ZONE_COUNT; z++) {
+    Serial.print(F(", T"));
+    Serial.print(z);
+    Serial.print(F("(C), P"));
+    Serial.print(z);
+    Serial.print(F("(%)"));
+  }
+  Serial.println();
+  #else
   Serial.println(F("Time(ms), Temp(C), Target(C), P, I, Power(%), Error(C)"));
+  #endif
   Serial.println(F("---"));
 }
 
 void sendDataLog(unsigned long t, float temp) {
+  // Colonnes communes : moyenne des zones pour Temp, P, I, Power et Error
+  // (identiques aux valeurs de la zone unique en mono-zone)
+  float p = 0, i = 0, error = 0;
+  for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+    p += getPIDProportional(z);
+    i += getPIDIntegral(z);
+    error += getPIDError(z);
+  }
   Serial.print(t);
   Serial.print(F(", "));
   Serial.print(temp, 1);
   Serial.print(F(", "));
   Serial.print(targetTemp, 1);
   Serial.print(F(", "));
-  Serial.print(getPIDProportional(), 1);
+  Serial.print(p / ZONE_COUNT, 1);
   Serial.print(F(", "));
-  Serial.print(getPIDIntegral(), 1);
+  Serial.print(i / ZONE_COUNT, 1);
   Serial.print(F(", "));
-  Serial.print(getPowerHold());
+  Serial.print(getAveragePowerHold());
   Serial.print(F(", "));
-  Serial.println(getPIDError(), 1);
+  #if ZONE_COUNT > 1
+  Serial.print(error / ZONE_COUNT, 1);
+  for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+    Serial.print(F(", "));
+    Serial.print(getZoneTemperature(z), 1);
+    Serial.print(F(", "));
+    Serial.print(getZonePowerHold(z));
+  }
+  Serial.println();
+  #else
+  Serial.println(error, 1);
+  #endif
 }
 
 void sendProgramStartLog(float temp) {
@@ -743,6 +847,8 @@ void sendProgramStartLog(float temp) {
   Serial.print(KI, 2);
   Serial.print(F(" maxDelta="));
   Serial.print(settings.maxDelta);
+  Serial.print(F("C smooth="));
+  Serial.print(settings.smoothing);
   Serial.println(F("C"));
   Serial.println();
   
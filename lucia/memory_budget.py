@@ -0,0 +1,113 @@
+#!/usr/bin/env python3
+"""
+Memory Budget - Rapport Flash/RAM par fonctionnalité du firmware LUCIA
+Auteur: CalciferAi Project
+Description: Compile le croquis avec arduino-cli pour chaque combinaison de
+             fonctionnalités (ENABLE_*) et affiche l'occupation Flash/RAM,
+             le coût de chaque option et les dépassements de budget.
+
+Usage: python3 memory_budget.py [--fqbn arduino:avr:uno]
+Code de sortie 1 si une configuration dépasse son budget, 2 sans arduino-cli.
+"""
+
+import argparse
+import os
+import re
+import shutil
+import subprocess
+import sys
+from typing import Dict, List, Optional, Tuple
+
+# Configuration
+SKETCH_DIR = os.path.dirname(os.path.abspath(__file__))  # Dossier lucia/
+FLASH_MAX = 32256  # Octets Flash disponibles sur Uno (bootloader déduit)
+RAM_MAX = 2048     # Octets RAM ATmega328P
+STACK_RESERVE = 250  # RAM à garder libre pour la pile (appels imbriqués + ISR)
+
+# Configurations à compiler : (nom, options ENABLE_*)
+CONFIGURATIONS: List[Tuple[str, List[str]]] = [
+    ("Minimal", []),
+    ("+ Logging", ["ENABLE_LOGGING"]),
+    ("+ Graphe", ["ENABLE_GRAPH"]),
+    ("+ Historique", ["ENABLE_HISTORY"]),
+    ("+ Full buffer", ["ENABLE_FULL_BUFFER"]),
+    ("Logging + Graphe + Full buffer", ["ENABLE_LOGGING", "ENABLE_GRAPH", "ENABLE_FULL_BUFFER"]),
+    ("Complet", ["ENABLE_LOGGING", "ENABLE_GRAPH", "ENABLE_HISTORY", "ENABLE_FULL_BUFFER"]),
+]
+
+FLASH_PATTERN = re.compile(r"Sketch uses (\d+) bytes")
+RAM_PATTERN = re.compile(r"Global variables use (\d+) bytes")
+
+
+def compile_configuration(fqbn: str, features: List[str]) -> Optional[Tuple[int, int]]:
+    """
+    Compile le croquis avec les options données.
+
+    Args:
+        fqbn: Carte cible pour arduino-cli (ex: arduino:avr:uno).
+        features: Liste des macros ENABLE_* à définir.
+
+    Returns:
+        Tuple (flash, ram) en octets, ou None si la compilation échoue.
+    """
+    # LUCIA_BUILD_FEATURES désactive les #define de definitions.h
+    flags = " ".join(["-DLUCIA_BUILD_FEATURES"] + [f"-D{name}" for name in features])
+    cmd = [
+        "arduino-cli", "compile",
+        "--fqbn", fqbn,
+        "--build-property", f"compiler.cpp.extra_flags={flags}",
+        SKETCH_DIR,
+    ]
+    result = subprocess.run(cmd, capture_output=True, text=True)
+    output = result.stdout + result.stderr
+    flash = FLASH_PATTERN.search(output)
+    ram = RAM_PATTERN.search(output)
+    if result.returncode != 0 or not flash or not ram:
+        return None
+    return int(flash.group(1)), int(ram.group(1))
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description="Rapport Flash/RAM par fonctionnalité")
+    parser.add_argument("--fqbn", default="arduino:avr:uno", help="Carte cible arduino-cli")
+    args = parser.parse_args()
+
+    if shutil.which("arduino-cli") is None:
+        print("❌ arduino-cli introuvable : installer arduino-cli et le core arduino:avr "
+              "(aucune mesure possible)")
+        return 2
+
+    ram_budget = RAM_MAX - STACK_RESERVE
+    results: Dict[str, Optional[Tuple[int, int]]] = {}
+    over_budget = False
+
+    print(f"Budget : Flash {FLASH_MAX} octets, RAM {ram_budget} octets "
+          f"({STACK_RESERVE} réservés à la pile)")
+    print()
+    print(f"{'Configuration':<34} {'Flash':>7} {'ΔFlash':>7} {'RAM':>6} {'ΔRAM':>6}  État")
+    print("-" * 72)
+
+    for name, features in CONFIGURATIONS:
+        # Full buffer refusé à la compilation sur Uno (#error dans display.h)
+        if "ENABLE_FULL_BUFFER" in features and args.fqbn.endswith(":uno"):
+            continue
+        sizes = compile_configuration(args.fqbn, features)
+        results[name] = sizes
+        if sizes is None:
+            print(f"{name:<34} {'échec de compilation':>29}  ❌")
+            over_budget = True
+            continue
+
+        flash, ram = sizes
+        base = results.get("Minimal")
+        d_flash = f"{flash - base[0]:+d}" if base else ""
+        d_ram = f"{ram - base[1]:+d}" if base else ""
+        ok = flash <= FLASH_MAX and ram <= ram_budget
+        over_budget |= not ok
+        print(f"{name:<34} {flash:>7} {d_flash:>7} {ram:>6} {d_ram:>6}  {'✅' if ok else '❌'}")
+
+    return 1 if over_budget else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -7,9 +7,13 @@
 #include "temperature.h"
 
 // Pin definitions
-#define PIN_RELAY 6
 #define PIN_LED A1
 
+// Thermocouples et relais par zone
+static const uint8_t zoneRelayPins[ZONE_COUNT] = ZONE_RELAY_PINS;
+static const uint8_t zoneCSPins[ZONE_COUNT] = ZONE_CS_PINS;
+static Adafruit_MAX31856 thermocouples[ZONE_COUNT] = ZONE_CS_PINS;
+
 // PID Parameters (variables modifiables)
 float KP = 2.5;
 float KI = 0.03;
@@ -19,39 +23,55 @@ float KI = 0.03;
 unsigned int CYCLE_LENGTH = 1000;  // Cycle PWM de 1 seconde par défaut
 
 // Global variables
-float powerHold = 0;        // 0-100%
-bool powerON = false;
-unsigned long pwmCycleStart = 0;
-
-// PID variables (optimized for RAM)
-long integralError = 0;     // Scaled by 100 (long pour éviter overflow)
-int lastError = 0;          // Scaled by 100
-int lastPowerHold = 0;      // 0-10000 (scaled by 100)
+// powerHold (float) et powerON supprimés : dérivés de lastPowerHold (économie 5 octets RAM)
+unsigned long pwmCycleStart = 0;  // Cycle commun, chaque zone y est décalée
 unsigned long lastPIDUpdate = 0;
 
-// PID Components (valeurs résultantes du dernier calcul)
-float pidProportional = 0.0;
-float pidIntegral = 0.0;
-// pidDerivative supprimé : terme D non utilisé
+// État de contrôle d'une zone (optimized for RAM : 20 octets)
+struct ZoneControl {
+  float temperature;     // Dernière lecture de la sonde (NAN si défaut)
+  long integralError;    // Scaled by 100 (long pour éviter overflow)
+  int lastError;         // Scaled by 100
+  int lastPowerHold;     // 0-10000 (scaled by 100)
+  // PID Components (valeurs résultantes du dernier calcul)
+  float pidProportional;
+  float pidIntegral;
+  // pidDerivative supprimé : terme D non utilisé
+};
+
+static ZoneControl zones[ZONE_COUNT];
+static uint8_t nextZoneToRead = 0;
 
 void initTemperatureControl() {
-  pinMode(PIN_RELAY, OUTPUT);
   pinMode(PIN_LED, OUTPUT);
-  digitalWrite(PIN_RELAY, LOW);
   digitalWrite(PIN_LED, LOW);
-  powerHold = 0;
-  powerON = false;
-  integralError = 0;
-  lastError = 0;
-  lastPowerHold = 0;
-  pwmCycleStart = millis(); // Initialiser le cycle PWM au démarrage
-  // Initialiser dans le passé pour forcer le premier calcul PID immédiat
-  lastPIDUpdate = millis() - PID_UPDATE_INTERVAL;
+  for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+    pinMode(zoneRelayPins[z], OUTPUT);
+    digitalWrite(zoneRelayPins[z], LOW);
+    zones[z].temperature = NAN;
+  }
+  resetPID();
 }
 
-float readTemperature() {
+void initThermocouplePins() {
+  for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+    pinMode(zoneCSPins[z], OUTPUT);
+    digitalWrite(zoneCSPins[z], HIGH); // CS doit être HIGH quand non utilisé
+  }
+}
+
+bool beginThermocouples() {
+  for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+    if (!thermocouples[z].begin()) return false;
+    thermocouples[z].setThermocoupleType(MAX31856_TCTYPE_S);
+    thermocouples[z].setConversionMode(MAX31856_CONTINUOUS);
+  }
+  return true;
+}
+
+static float readZoneTemperature(uint8_t zone) {
   // Lire d'abord la température (la bibliothèque gère le timing SPI)
-  float temp = max31856.readThermocoupleTemperature();
+  float temp = thermocouples[zone].readThermocoupleTemperature();
   
   // Vérifier si la lecture est valide
   if (isnan(temp)) {
@@ -66,122 +86,138 @@ float readTemperature() {
   return temp;
 }
 
+float readTemperature() {
+  for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+    zones[z].temperature = readZoneTemperature(z);
+  }
+  return getAverageTemperature();
+}
+
+void readNextZone() {
+  // Une seule transaction SPI par appel : les zones sont lues tour à tour
+  zones[nextZoneToRead].temperature = readZoneTemperature(nextZoneToRead);
+  if (++nextZoneToRead >= ZONE_COUNT) nextZoneToRead = 0;
+}
+
+static bool isPlausible(float temp) {
+  return !isnan(temp) && temp >= TEMP_VALID_MIN && temp <= TEMP_VALID_MAX;
+}
+
+bool zoneTemperaturesValid() {
+  // Contrôle zone par zone : une zone qui s'emballe ne doit pas être masquée par la moyenne
+  for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+    if (!isPlausible(zones[z].temperature)) return false;
+  }
+  return true;
+}
+
+float getAverageTemperature() {
+  // Une zone en défaut invalide la moyenne : la sécurité TEMP_FAIL_TIMEOUT s'applique
+  float sum = 0;
+  for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+    if (isnan(zones[z].temperature)) return NAN;
+    sum += zones[z].temperature;
+  }
+  return sum / ZONE_COUNT;
+}
+
 void resetPID() {
-  integralError = 0;
-  lastError = 0;
-  lastPowerHold = 0;
+  for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+    zones[z].integralError = 0;
+    zones[z].lastError = 0;
+    zones[z].lastPowerHold = 0;
+  }
   pwmCycleStart = millis(); // Réinitialiser le cycle PWM
   // Initialiser dans le passé pour forcer le premier calcul PID immédiat
   lastPIDUpdate = millis() - PID_UPDATE_INTERVAL;
 }
 
-// Fonction helper : réinitialise le cycle PWM si nécessaire
-static void resetPWMCycleIfNeeded(unsigned long currentMillis) {
-  unsigned long cycleElapsed = currentMillis - pwmCycleStart;
-  if (cycleElapsed >= CYCLE_LENGTH) {
-    pwmCycleStart = currentMillis;
-  }
+// Commande du relais d'une zone, la LED reflète l'état global (au moins un relais ON)
+static void setZoneRelay(uint8_t zone, bool state) {
+  static uint8_t relayMask = 0;
+  digitalWrite(zoneRelayPins[zone], state ? HIGH : LOW);
+  if (state) relayMask |= (1 << zone);
+  else relayMask &= ~(1 << zone);
+  digitalWrite(PIN_LED, relayMask ? HIGH : LOW);
 }
 
 // Fonction interne : gestion du PWM logiciel (doit s'exécuter à chaque loop)
 void updatePWM(unsigned long currentMillis) {
-  // Cas spécial 100% : relais toujours ON
-  if (lastPowerHold >= 10000) {
-    setRelay(true);
-    resetPWMCycleIfNeeded(currentMillis);
-    return;
-  }
-  
-  // Cas spécial 0% : relais toujours OFF
-  if (lastPowerHold <= 0) {
-    setRelay(false);
-    resetPWMCycleIfNeeded(currentMillis);
-    return;
-  }
-  
-  // Cas normal : PWM entre 0% et 100%
+  // Démarrer un nouveau cycle si nécessaire (cycle commun à toutes les zones)
   unsigned long cycleElapsed = currentMillis - pwmCycleStart;
-  
-  // Démarrer un nouveau cycle si nécessaire
   if (cycleElapsed >= CYCLE_LENGTH) {
     pwmCycleStart = currentMillis;
     cycleElapsed = 0;
   }
   
-  // Calculer le temps ON pour ce cycle (lastPowerHold est scalé 0-10000 pour précision)
-  // Exemple : lastPowerHold=5000 (50%), CYCLE_LENGTH=1000ms → onTime=500ms
-  unsigned long onTime = ((unsigned long)lastPowerHold * (unsigned long)CYCLE_LENGTH) / 10000UL;
-  
-  // Contrôler le relais selon la position dans le cycle PWM
-  if (cycleElapsed < onTime) {
-    setRelay(true);
-  } else {
-    setRelay(false);
+  for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+    int power = zones[z].lastPowerHold;
+    
+    // Cas spéciaux 100% / 0% : relais toujours ON / OFF
+    if (power >= 10000 || power <= 0) {
+      setZoneRelay(z, power > 0);
+      continue;
+    }
+    
+    // Fenêtres ON entrelacées : la zone z démarre à z/ZONE_COUNT du cycle,
+    // les relais ne commutent jamais ensemble (pic de courant réduit)
+    unsigned long offset = (unsigned long)CYCLE_LENGTH * z / ZONE_COUNT;
+    unsigned long position = (cycleElapsed + CYCLE_LENGTH - offset) % CYCLE_LENGTH;
+    
+    // Calculer le temps ON pour ce cycle (lastPowerHold est scalé 0-10000 pour précision)
+    // Exemple : lastPowerHold=5000 (50%), CYCLE_LENGTH=1000ms → onTime=500ms
+    unsigned long onTime = ((unsigned long)power * (unsigned long)CYCLE_LENGTH) / 10000UL;
+    
+    // Contrôler le relais selon la position dans le cycle PWM
+    setZoneRelay(z, position < onTime);
   }
 }
 
-void updateTemperatureControl(float currentTemp, float targetTemp, bool enabled, unsigned long currentMillis) {
-  // Si le contrôle est désactivé : arrêt du chauffage et réinitialisation PID
-  if (!enabled) {
-    powerHold = 0;
-    lastPowerHold = 0;
-    setRelay(false);
-    integralError = 0;
-    lastError = 0;
+// Calcul PI d'une zone (sortie dans zone.lastPowerHold)
+static void updateZonePID(ZoneControl &zone, float targetTemp, float dt) {
+  // Sonde en défaut ou hors plage : zone coupée (pas de chauffe sans mesure fiable),
+  // les autres zones continuent ; l'arrêt complet du programme reste géré par TEMP_FAIL_TIMEOUT
+  if (!isPlausible(zone.temperature)) {
+    zone.lastPowerHold = 0;
+    zone.integralError = 0;
+    zone.pidProportional = 0;
+    zone.pidIntegral = 0;
     return;
   }
   
-  // Le PWM s'exécute à chaque appel pour un contrôle précis du relais
-  updatePWM(currentMillis);
-  
-  // Le calcul PID s'exécute à intervalle régulier (défini dans definitions.h)
-  // L'inertie thermique élevée d'un four céramique ne nécessite pas un calcul plus fréquent
-  if (currentMillis - lastPIDUpdate < PID_UPDATE_INTERVAL) {
-    return;  // Attendre le prochain intervalle de calcul
-  }
-  
-  // Calculer le delta de temps en secondes (limité pour assurer la stabilité)
-  float dt = (currentMillis - lastPIDUpdate) / 1000.0;
-  // Protection contre les valeurs aberrantes (pause, débordement, premier appel)
-  // Si dt est trop grand ou trop petit, utiliser l'intervalle nominal
-  if (dt < 0.5 || dt > 2.0) {
-    dt = PID_UPDATE_INTERVAL / 1000.0;  // Utiliser la valeur nominale (1.0 seconde)
-  }
-  lastPIDUpdate = currentMillis;
-  
   // Calculer l'erreur de température (scalée x100 pour optimisation)
-  int error = (int)((targetTemp - currentTemp) * 100);
+  int error = (int)((targetTemp - zone.temperature) * 100);
   
   // Calcul du terme proportionnel (P)
-  pidProportional = KP * (error / 100.0);
+  zone.pidProportional = KP * (error / 100.0);
   
   // Calcul du terme intégral (I) avec accumulation conditionnelle
   // Anti-windup conditionnel : ne pas accumuler si la puissance est déjà saturée
   // Cela évite l'accumulation inutile quand le four est déjà à 100% de puissance
-  if (lastPowerHold < 10000) {  // Si puissance < 100%
-    integralError += (int)(error * dt);
+  if (zone.lastPowerHold < 10000) {  // Si puissance < 100%
+    zone.integralError += (int)(error * dt);
   }
   
   // Anti-windup : limiter l'accumulation du terme intégral pour éviter la saturation
   long maxIntegral = (long)(100000.0 / KI);  // Ajusté pour le nouveau scaling (x10)
-  if (integralError > maxIntegral) integralError = maxIntegral;
-  if (integralError < -maxIntegral) integralError = -maxIntegral;
+  if (zone.integralError > maxIntegral) zone.integralError = maxIntegral;
+  if (zone.integralError < -maxIntegral) zone.integralError = -maxIntegral;
   
-  pidIntegral = KI * (integralError / 1000.0);  // Divisé par 10 pour réponse plus lente
+  zone.pidIntegral = KI * (zone.integralError / 1000.0);  // Divisé par 10 pour réponse plus lente
   
   // Terme D (dérivé) supprimé : non nécessaire pour four céramique (inertie élevée)
   // Économie : ~8 bytes RAM + ~100 bytes Flash
   
   // Calculer la nouvelle puissance de sortie PID (PI seulement, pas D)
-  int newPowerHoldScaled = (int)((pidProportional + pidIntegral) * 100);
+  int newPowerHoldScaled = (int)((zone.pidProportional + zone.pidIntegral) * 100);
   
   // Limiter le taux de changement de puissance (sécurité four)
   // Évite les variations brutales qui pourraient endommager les résistances
-  int powerChange = newPowerHoldScaled - lastPowerHold;
+  int powerChange = newPowerHoldScaled - zone.lastPowerHold;
   if (powerChange > MAX_POWER_CHANGE * 100) {
-    newPowerHoldScaled = lastPowerHold + (int)(MAX_POWER_CHANGE * 100);
+    newPowerHoldScaled = zone.lastPowerHold + (int)(MAX_POWER_CHANGE * 100);
   } else if (powerChange < -MAX_POWER_CHANGE * 100) {
-    newPowerHoldScaled = lastPowerHold - (int)(MAX_POWER_CHANGE * 100);
+    newPowerHoldScaled = zone.lastPowerHold - (int)(MAX_POWER_CHANGE * 100);
   }
   
   // Contraindre la sortie dans la plage valide (0-100%)
@@ -189,32 +225,99 @@ void updateTemperatureControl(float currentTemp, float targetTemp, bool enabled,
   if (newPowerHoldScaled < 0) newPowerHoldScaled = 0;
   
   // Mettre à jour les variables de sortie
-  powerHold = newPowerHoldScaled / 100.0;
-  lastPowerHold = newPowerHoldScaled;
-  lastError = error;
+  zone.lastPowerHold = newPowerHoldScaled;
+  zone.lastError = error;
+}
+
+void updateTemperatureControl(float targetTemp, bool enabled, unsigned long currentMillis) {
+  // Si le contrôle est désactivé : arrêt du chauffage et réinitialisation PID
+  if (!enabled) {
+    for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+      zones[z].lastPowerHold = 0;
+      zones[z].integralError = 0;
+      zones[z].lastError = 0;
+    }
+    setRelay(false);
+    return;
+  }
+  
+  // Le PWM s'exécute à chaque appel pour un contrôle précis du relais
+  updatePWM(currentMillis);
+  
+  // Le calcul PID s'exécute à intervalle régulier (défini dans definitions.h)
+  // L'inertie thermique élevée d'un four céramique ne nécessite pas un calcul plus fréquent
+  if (currentMillis - lastPIDUpdate < PID_UPDATE_INTERVAL) {
+    return;  // Attendre le prochain intervalle de calcul
+  }
+  
+  // Calculer le delta de temps en secondes (limité pour assurer la stabilité)
+  float dt = (currentMillis - lastPIDUpdate) / 1000.0;
+  // Protection contre les valeurs aberrantes (pause, débordement, premier appel)
+  // Si dt est trop grand ou trop petit, utiliser l'intervalle nominal
+  if (dt < 0.5 || dt > 2.0) {
+    dt = PID_UPDATE_INTERVAL / 1000.0;  // Utiliser la valeur nominale (1.0 seconde)
+  }
+  lastPIDUpdate = currentMillis;
+  
+  #if ZONE_COUNT > 1 && defined(ENABLE_ZONE_BALANCE)
+  float average = getAverageTemperature();
+  #endif
+  
+  for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+    float zoneTarget = targetTemp;
+    #if ZONE_COUNT > 1 && defined(ENABLE_ZONE_BALANCE)
+    // Zone froide : consigne relevée, zone chaude : consigne abaissée
+    if (!isnan(average)) {
+      float offset = ZONE_BALANCE_GAIN * (average - zones[z].temperature);
+      zoneTarget += constrain(offset, -ZONE_BALANCE_MAX, ZONE_BALANCE_MAX);
+    }
+    #endif
+    updateZonePID(zones[z], zoneTarget, dt);
+  }
 }
 
 void setRelay(bool state) {
-  powerON = state;
-  digitalWrite(PIN_RELAY, state ? HIGH : LOW);
-  digitalWrite(PIN_LED, state ? HIGH : LOW);
+  for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+    setZoneRelay(z, state);
+  }
 }
 
 int getPowerHold() {
-  return (int)powerHold;
+  // Zone la plus sollicitée : c'est elle qui révèle l'usure des résistances
+  int maxPower = 0;
+  for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+    if (zones[z].lastPowerHold > maxPower) maxPower = zones[z].lastPowerHold;
+  }
+  return maxPower / 100;
+}
+
+int getAveragePowerHold() {
+  // Chaque zone porte une part égale de KILN_POWER_W
+  long sum = 0;
+  for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+    sum += zones[z].lastPowerHold;
+  }
+  return sum / ZONE_COUNT / 100;
+}
+
+float getZoneTemperature(uint8_t zone) {
+  return zones[zone].temperature;
+}
+
+int getZonePowerHold(uint8_t zone) {
+  return zones[zone].lastPowerHold / 100;
 }
 
 // Getters pour les composantes PID (valeurs résultantes)
-float getPIDProportional() {
-  return pidProportional;
+float getPIDProportional(uint8_t zone) {
+  return zones[zone].pidProportional;
 }
 
-float getPIDIntegral() {
-  return pidIntegral;
+float getPIDIntegral(uint8_t zone) {
+  return zones[zone].pidIntegral;
 }
 
-float getPIDError() {
+float getPIDError(uint8_t zone) {
   // Retourner l'erreur en degrés (lastError est scalé x100)
-  return lastError / 100.0;
+  return zones[zone].lastError / 100.0;
 }
-
@@ -7,8 +7,27 @@
 
 #include <Adafruit_MAX31856.h>
 
-// External references
-extern Adafruit_MAX31856 max31856;
+// ===== ZONES DE CHAUFFE =====
+// Une zone = un thermocouple MAX31856 + un relais SSR avec son propre PID
+// (ex : bancs de résistances haut/bas). 1 zone = four standard.
+#define ZONE_COUNT 1
+#define ZONE_CS_PINS {10}     // CS des MAX31856 (2 zones : {10, 7})
+#define ZONE_RELAY_PINS {6}   // Relais SSR (2 zones : {6, A2})
+
+// Équilibrage des zones : la consigne de chaque zone est décalée vers la moyenne
+// pour réduire l'écart haut/bas (sans effet avec une seule zone)
+//#define ENABLE_ZONE_BALANCE
+#define ZONE_BALANCE_GAIN 0.5  // Fraction de l'écart à la moyenne ajoutée à la consigne
+#define ZONE_BALANCE_MAX 15    // Décalage max de consigne (°C)
+
+// Plage plausible d'une sonde : hors plage sur une seule zone, celle-ci est coupée
+// et le programme s'arrête après TEMP_FAIL_TIMEOUT
+#define TEMP_VALID_MIN -100
+#define TEMP_VALID_MAX 1500
+
+#if ZONE_COUNT < 1 || ZONE_COUNT > 3
+#error "ZONE_COUNT doit être entre 1 et 3 (affichage limité à 3 valeurs par ligne)"
+#endif
 
 // PID Parameters (variables externes modifiables via l'interface Settings)
 extern float KP;  // Gain proportionnel : réaction immédiate à l'erreur
@@ -23,18 +42,27 @@ extern unsigned int CYCLE_LENGTH; // Cycle PWM en millisecondes (modifiable)
 
 // Function declarations
 void initTemperatureControl();
-float readTemperature();
+void initThermocouplePins();   // CS de toutes les zones à HIGH (avant SPI.begin())
+bool beginThermocouples();     // Initialise tous les MAX31856, false si l'un est absent
+float readTemperature();       // Lit toutes les zones immédiatement, retourne la moyenne
+void readNextZone();           // Lit une seule zone (lectures SPI décalées, tour à tour)
+float getAverageTemperature(); // Moyenne des zones (NAN si une zone est en défaut)
+bool zoneTemperaturesValid();  // false si une zone est en défaut ou hors plage plausible
 float getCurrentTemperature(); // Retourne la température mise en cache (lue toutes les 500ms)
-void updateTemperatureControl(float currentTemp, float targetTemp, bool enabled, unsigned long currentMillis);
-void setRelay(bool state);
-int getPowerHold();
+void updateTemperatureControl(float targetTemp, bool enabled, unsigned long currentMillis);
+void setRelay(bool state);     // Toutes les zones
+int getPowerHold();            // Puissance de la zone la plus sollicitée (%) : usure des résistances
+int getAveragePowerHold();     // Puissance moyenne des zones (%) : énergie (KILN_POWER_W = total)
 void resetPID();
 
-// PID Components Getters (valeurs résultantes du calcul PID)
-float getPIDProportional();  // Retourne la valeur du terme P
-float getPIDIntegral();      // Retourne la valeur du terme I
+// Valeurs par zone (affichage et logs)
+float getZoneTemperature(uint8_t zone);
+int getZonePowerHold(uint8_t zone);
+
+// PID Components Getters (valeurs résultantes du calcul PID, zone 0 par défaut)
+float getPIDProportional(uint8_t zone = 0);  // Retourne la valeur du terme P
+float getPIDIntegral(uint8_t zone = 0);      // Retourne la valeur du terme I
 // getPIDDerivative() supprimé : terme D non utilisé
-float getPIDError();         // Retourne l'erreur actuelle (Target - Sonde) en degrés
+float getPIDError(uint8_t zone = 0);         // Retourne l'erreur actuelle (Target - Sonde) en degrés
 
 #endif
-